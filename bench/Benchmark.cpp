@@ -0,0 +1,140 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <AllocationHook.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    //batches shorter than this are too noisy to time
+    const std::chrono::milliseconds minBatchTime(20);
+    const sf::Uint64 maxBatchSize = 1u << 30;
+    const std::size_t sampleCount = 5u;
+
+    std::atomic<sf::Uint64> allocationCount(0u);
+    std::atomic<sf::Uint64> allocationBytes(0u);
+
+    void countAllocation(std::size_t bytes)
+    {
+        allocationCount.fetch_add(1u, std::memory_order_relaxed);
+        allocationBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    double runBatch(const Bench::Runner::Operation& op, sf::Uint64 size)
+    {
+        const auto start = Clock::now();
+        for (auto i = 0u; i < size; ++i) op();
+        return std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(Clock::now() - start).count();
+    }
+}
+
+using namespace Bench;
+
+Runner::Runner(const std::string& filter)
+    : m_filter(filter)
+{
+    AllocationHook::setCallback(countAllocation);
+}
+
+//public
+bool Runner::enabled(const std::string& name) const
+{
+    return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void Runner::run(const std::string& name, const Operation& op)
+{
+    if (!enabled(name)) return;
+
+    //warm caches and pools, then double the batch until it's long enough
+    op();
+    sf::Uint64 batchSize = 1u;
+    while (batchSize < maxBatchSize
+        && runBatch(op, batchSize) < std::chrono::duration_cast<std::chrono::nanoseconds>(minBatchTime).count())
+    {
+        batchSize *= 2u;
+    }
+
+    std::vector<double> samples;
+    const sf::Uint64 startCount = allocationCount;
+    const sf::Uint64 startBytes = allocationBytes;
+    for (auto i = 0u; i < sampleCount; ++i)
+        samples.push_back(runBatch(op, batchSize) / batchSize);
+    const double operations = static_cast<double>(batchSize * sampleCount);
+
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = name;
+    result.iterations = batchSize;
+    result.nsPerOp = samples[samples.size() / 2];
+    result.allocationsPerOp = (allocationCount - startCount) / operations;
+    result.bytesPerOp = (allocationBytes - startBytes) / operations;
+    m_results.push_back(result);
+
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed
+        << std::setprecision(1) << std::setw(14) << result.nsPerOp << " ns/op"
+        << std::setprecision(2) << std::setw(10) << result.allocationsPerOp << " allocs/op"
+        << std::setprecision(0) << std::setw(10) << result.bytesPerOp << " B/op" << std::endl;
+}
+
+const std::vector<Result>& Runner::getResults() const
+{
+    return m_results;
+}
+
+bool Runner::writeJson(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.good())
+    {
+        std::cerr << "Benchmark: failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{" << std::endl << "    \"benchmarks\": [" << std::endl;
+    for (auto i = 0u; i < m_results.size(); ++i)
+    {
+        const auto& r = m_results[i];
+        file << "        { \"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.nsPerOp << ", \"allocs_per_op\": " << r.allocationsPerOp
+            << ", \"bytes_per_op\": " << r.bytesPerOp << " }" << ((i + 1 < m_results.size()) ? "," : "") << std::endl;
+    }
+    file << "    ]" << std::endl << "}" << std::endl;
+    return true;
+}
\ No newline at end of file
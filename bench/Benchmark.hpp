@@ -0,0 +1,74 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//minimal benchmark harness. each benchmark is run in batches long enough to
+//time reliably, and reports the median time and mean allocations per operation
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <SFML/Config.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    struct Result final
+    {
+        std::string name;
+        sf::Uint64 iterations = 0u; //per sample
+        double nsPerOp = 0.0;
+        double allocationsPerOp = 0.0;
+        double bytesPerOp = 0.0;
+    };
+
+    class Runner final
+    {
+    public:
+        typedef std::function<void()> Operation;
+
+        //only benchmarks whose names contain the filter are run
+        explicit Runner(const std::string& filter = "");
+        ~Runner() = default;
+
+        //check this before any expensive set up
+        bool enabled(const std::string& name) const;
+        //times the operation and prints the result
+        void run(const std::string& name, const Operation& op);
+
+        const std::vector<Result>& getResults() const;
+        bool writeJson(const std::string& path) const;
+
+    private:
+        std::string m_filter;
+        std::vector<Result> m_results;
+    };
+}
+
+#endif //BENCHMARK_H_
\ No newline at end of file
@@ -0,0 +1,298 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//benchmarks for the game's hot paths. run from the directory containing res/
+//crush_bench [--filter <name>] [--json <file>]
+
+#include "Benchmark.hpp"
+
+#include <JobSystem.hpp>
+#include <CollisionWorld.hpp>
+#include <Particles.hpp>
+#include <WaterDrawable.hpp>
+#include <Map.hpp>
+#include <SpriteSheet.hpp>
+#include <AnimationLibrary.hpp>
+#include <Scene.hpp>
+#include <Node.hpp>
+#include <CommandStack.hpp>
+#include <Observer.hpp>
+
+#include <SFML/Graphics/Shader.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const float tickTime = 1.f / 60.f;
+
+    void benchCollision(Bench::Runner& runner, JobSystem& jobSystem)
+    {
+        for (auto count : { 100u, 1000u, 10000u })
+        {
+            const std::string name = "CollisionWorld::step/" + std::to_string(count);
+            if (!runner.enabled(name)) continue;
+
+            //a grid of blocks dropped onto a floor
+            CollisionWorld world(70.f, jobSystem);
+            const sf::Vector2f blockSize(40.f, 40.f);
+            const auto columns = static_cast<sf::Uint32>(std::ceil(std::sqrt(static_cast<float>(count))));
+            const float spacing = 44.f;
+
+            auto floor = world.addBody(CollisionWorld::Body::Solid, { columns * spacing, 40.f });
+            floor->setPosition({ 0.f, (count / columns + 2) * spacing });
+            for (auto i = 0u; i < count; ++i)
+            {
+                auto body = world.addBody(CollisionWorld::Body::Block, blockSize);
+                body->setPosition({ (i % columns) * spacing, (i / columns) * spacing });
+            }
+
+            //let everything land so the steady state is measured
+            for (auto i = 0u; i < 120u; ++i)
+                world.step(tickTime);
+
+            runner.run(name, [&world]()
+            {
+                world.step(tickTime);
+            });
+        }
+    }
+
+    void benchParticles(Bench::Runner& runner)
+    {
+        const sf::Uint32 count = 10000u;
+        const std::string updateName = "ParticleSystem::update/" + std::to_string(count);
+        const std::string snapshotName = "ParticleSystem::getSnapshot/" + std::to_string(count);
+        if (!runner.enabled(updateName) && !runner.enabled(snapshotName)) return;
+
+        const float lifetime = 2.f;
+        ParticleSystem particles(Particle::Type::Sparkle);
+        particles.setCapacity(count);
+        particles.setParticleLifetime(lifetime);
+        particles.setEmitRate(count / lifetime);
+        particles.setRandomInitialVelocity({ { -100.f, -200.f }, { 100.f, -200.f }, { -50.f, -100.f }, { 50.f, -100.f } });
+        particles.setPosition({ 960.f, 540.f });
+        particles.start();
+
+        //fill to capacity
+        for (auto i = 0u; i < 180u; ++i)
+            particles.update(tickTime);
+
+        runner.run(updateName, [&particles]()
+        {
+            particles.update(tickTime);
+        });
+
+        ParticleSystem::Snapshot snapshot;
+        runner.run(snapshotName, [&particles, &snapshot]()
+        {
+            particles.getSnapshot(snapshot);
+        });
+    }
+
+    void benchWater(Bench::Runner& runner, JobSystem& jobSystem)
+    {
+        const sf::Uint32 count = 8u;
+        const std::string name = "WaterDrawable::update/" + std::to_string(count);
+        if (!runner.enabled(name)) return;
+
+        //the normal map and shader are never loaded or drawn
+        Resource::Handle<sf::Texture> normalMap(std::make_shared<sf::Texture>());
+        sf::Shader shader;
+        std::list<WaterDrawable> bodies;
+        for (auto i = 0u; i < count; ++i)
+            bodies.emplace_back(normalMap, shader, sf::Vector2f(1920.f, 200.f));
+
+        sf::Uint32 op = 0u;
+        runner.run(name, [&bodies, &jobSystem, &op]()
+        {
+            //keeps the surface moving
+            if (++op % 30 == 0)
+                bodies.front().splash(static_cast<float>((op * 37u) % 1900u), 200.f);
+            WaterDrawable::update(bodies, tickTime, jobSystem);
+        });
+    }
+
+    void benchParsing(Bench::Runner& runner)
+    {
+        runner.run("Map/testmap3", []()
+        {
+            Map map("res/maps/testmap3.crm");
+        });
+
+        runner.run("SpriteSheet/scenery01/json", []()
+        {
+            SpriteSheet sheet("res/textures/atlases/scenery01.json", false);
+        });
+
+        //the cache is written next to the json, so a copy is made
+        //outside of res/ and removed along with its cache afterwards
+        const std::string cacheName = "SpriteSheet/scenery01/cache";
+        if (runner.enabled(cacheName))
+        {
+            const std::string jsonCopy = "bench_scenery01.json";
+            {
+                std::ifstream src("res/textures/atlases/scenery01.json", std::ios::binary);
+                std::ofstream dst(jsonCopy, std::ios::binary | std::ios::trunc);
+                dst << src.rdbuf();
+            }
+
+            //after the first load this reads the binary cache
+            runner.run(cacheName, [&jsonCopy]()
+            {
+                SpriteSheet sheet(jsonCopy);
+            });
+
+            std::remove(jsonCopy.c_str());
+            std::remove("bench_scenery01.cache");
+        }
+
+        runner.run("AnimationLibrary::parse/robot", []()
+        {
+            AnimationClipSet clipSet;
+            AnimationLibrary::parse("res/textures/characters/robot.cra", clipSet);
+        });
+    }
+
+    void benchCommands(Bench::Runner& runner)
+    {
+        const sf::Uint32 count = 1000u;
+        const std::string name = "Scene::executeCommand/" + std::to_string(count);
+        if (!runner.enabled(name)) return;
+
+        Scene scene;
+        const std::vector<Category::Type> categories = { Category::Block, Category::Npc, Category::Detail, Category::Water };
+        for (auto i = 0u; i < count; ++i)
+        {
+            auto node = std::make_unique<Node>();
+            node->setCategory(categories[i % categories.size()]);
+            scene.addNode(node, Scene::DynamicRear);
+        }
+
+        //the same path a controller's command takes through the stack each tick
+        CommandStack commandStack;
+        runner.run(name, [&scene, &commandStack]()
+        {
+            Command command;
+            command.categoryMask |= Category::Npc;
+            command.action = [](Node& n, float)
+            {
+                n.move(1.f, 0.f);
+            };
+            commandStack.push(command);
+
+            while (!commandStack.empty())
+                scene.executeCommand(commandStack.pop(), tickTime);
+        });
+    }
+
+    class EventSource final : public Subject
+    {
+    public:
+        void raise(const Event& evt)
+        {
+            notify(*this, evt);
+        }
+    };
+
+    class EventSink final : public Observer
+    {
+    public:
+        sf::Uint32 count = 0u;
+        void onNotify(Subject&, const Event& evt) override
+        {
+            if (evt.type == Event::Player) count++;
+        }
+    };
+
+    void benchEvents(Bench::Runner& runner)
+    {
+        const sf::Uint32 count = 8u;
+        const std::string name = "Subject::notify/" + std::to_string(count);
+        if (!runner.enabled(name)) return;
+
+        //about as many observers as a player node has in game
+        EventSource source;
+        std::vector<EventSink> sinks(count);
+        for (auto& s : sinks)
+            source.addObserver(s);
+
+        Event evt;
+        evt.type = Event::Player;
+        evt.player.playerId = Category::PlayerOne;
+        evt.player.action = Event::PlayerEvent::Moved;
+        evt.player.positionX = 0.f;
+        evt.player.positionY = 0.f;
+
+        runner.run(name, [&source, &evt]()
+        {
+            source.raise(evt);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonPath;
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (arg == "--json" && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: crush_bench [--filter <name>] [--json <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    Bench::Runner runner(filter);
+    JobSystem jobSystem;
+
+    benchCollision(runner, jobSystem);
+    benchParticles(runner);
+    benchWater(runner, jobSystem);
+    benchParsing(runner);
+    benchCommands(runner);
+    benchEvents(runner);
+
+    if (!jsonPath.empty() && !runner.writeJson(jsonPath))
+        return 1;
+
+    return 0;
+}
\ No newline at end of file
@@ -33,11 +33,18 @@ source distribution.
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
 
-struct Particle;
+#include <cstddef>
+#include <tuple>
+#include <random>
+#include <type_traits>
+
+struct ParticleData;
 struct ForceAffector
 {
     explicit ForceAffector(const sf::Vector2f& force);
-    void operator()(Particle& p, float dt);
+    void operator()(ParticleData& data, std::size_t index, float dt);
+    //applies the affector to all live particles
+    void apply(ParticleData& data, float dt);
     void setRandom(const sf::Vector2f& rangeStart, const sf::Vector2f& rangeEnd);
 
 private:
@@ -46,12 +53,16 @@ private:
     bool m_random;
     sf::Vector2f m_randomStart;
     sf::Vector2f m_randomEnd;
+    //each affector has its own engine so systems can be updated in parallel
+    std::minstd_rand m_randomEngine;
 };
 
 struct ColourAffector
 {
     ColourAffector(const sf::Color& start, const sf::Color& end, float duration);
-    void operator() (Particle& p, float dt);
+    void operator()(ParticleData& data, std::size_t index, float dt);
+    //applies the affector to all live particles
+    void apply(ParticleData& data, float dt);
 
 private:
     float m_duration;
@@ -62,7 +73,9 @@ private:
 struct RotateAffector
 {
     explicit RotateAffector(float rotation);
-    void operator() (Particle& p, float dt);
+    void operator()(ParticleData& data, std::size_t index, float dt);
+    //applies the affector to all live particles
+    void apply(ParticleData& data, float dt);
 
 private:
     float m_rotation;
@@ -71,8 +84,44 @@ private:
 struct ScaleAffector
 {
     explicit ScaleAffector(const sf::Vector2f& scale);
-    void operator() (Particle& p, float dt);
+    void operator()(ParticleData& data, std::size_t index, float dt);
+    //applies the affector to all live particles
+    void apply(ParticleData& data, float dt);
 private:
     sf::Vector2f m_scale;
 };
+//composes affectors at compile time so each one runs as a single
+//loop over the particle arrays instead of a call per particle
+template <typename... Affectors>
+class AffectorPipeline final
+{
+public:
+    explicit AffectorPipeline(const Affectors&... affectors)
+        : m_affectors(affectors...){}
+
+    void operator()(ParticleData& data, float dt)
+    {
+        apply<0u>(data, dt);
+    }
+
+private:
+    std::tuple<Affectors...> m_affectors;
+
+    template <std::size_t i>
+    typename std::enable_if<(i < sizeof...(Affectors))>::type apply(ParticleData& data, float dt)
+    {
+        std::get<i>(m_affectors).apply(data, dt);
+        apply<i + 1u>(data, dt);
+    }
+
+    template <std::size_t i>
+    typename std::enable_if<(i == sizeof...(Affectors))>::type apply(ParticleData&, float){}
+};
+
+template <typename... Affectors>
+AffectorPipeline<Affectors...> makeAffectorPipeline(const Affectors&... affectors)
+{
+    return AffectorPipeline<Affectors...>(affectors...);
+}
+
 #endif //AFFECTORS_H_
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//replaces the global allocation functions so that allocations can be
+//counted. shared by the game, which attributes them to profiler scopes,
+//and the benchmarks. as it replaces operator new for the whole program
+//it belongs to the executables rather than the core library
+
+#ifndef ALLOCATION_HOOK_H_
+#define ALLOCATION_HOOK_H_
+
+#include <cstddef>
+
+namespace AllocationHook
+{
+    //called with the size of every allocation. may be called from any
+    //thread, and must not allocate itself
+    typedef void(*Callback)(std::size_t bytes);
+
+    //nullptr stops counting
+    void setCallback(Callback callback);
+}
+
+#endif //ALLOCATION_HOOK_H_
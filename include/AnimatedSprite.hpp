@@ -30,41 +30,14 @@ source distribution.
 #ifndef ANISPRITE_H_
 #define ANISPRITE_H_
 
+#include <Resource.hpp>
+#include <AnimationLibrary.hpp>
+
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/NonCopyable.hpp>
 
 
-struct Animation
-{
-    friend class AnimatedSprite;
-    Animation(const std::string& name, sf::Int16 begin, sf::Int16 end, bool loop = true)
-        : m_name(name), m_startFrame(begin), m_endFrame(end), m_loop(loop){}
-
-    const std::string& getName() const
-    {
-        return m_name;
-    }
-
-private:
-    std::string m_name;
-    sf::Int16 m_startFrame;
-    sf::Int16 m_endFrame;
-    bool m_loop;
-};
-
-//functor for searching vectors of animations
-struct FindAnimation
-{
-    FindAnimation(const std::string& name) : m_name(name){}
-    bool operator()(const Animation& a)
-    {
-        return (a.getName() == m_name);
-    };
-private:
-    std::string m_name;
-};
-
 class TextureResource;
 class AnimatedSprite final : public sf::Drawable, public sf::Transformable//, private sf::NonCopyable
 {
@@ -79,8 +52,10 @@ public:
     void update(float dt);
 
     void setTexture(const sf::Texture& t);
+    //keeps the texture resident for as long as the sprite uses it
+    void setTexture(const Resource::Handle<sf::Texture>& t);
     const sf::Texture* getTexture() const;
-    void setNormalMap(const sf::Texture& t);
+    void setNormalMap(const Resource::Handle<sf::Texture>& t);
     void setShader(sf::Shader& shader);
     void setFrameSize(const sf::Vector2i& size);
     const sf::Vector2i& getFrameSize() const;
@@ -91,7 +66,10 @@ public:
     void setLooped(bool looped);
     bool looped() const;
     void play(sf::Int16 start = 0, sf::Int16 end = -1);
-    void play(Animation a);
+    void play(const Animation& a);
+    //plays a clip loaded from the sprite's .cra file
+    void playClip(sf::Int16 clipId);
+    void playClip(const std::string& clipName);
     bool playing() const;
     void setPaused(bool paused);
 
@@ -101,11 +79,16 @@ public:
     sf::FloatRect getGlobalBounds() const;
 
     const std::vector<Animation>& getAnimations()const;
+    //returns nullptr if the sprite has no clip with this name
+    const Animation* getAnimation(const std::string& name) const;
+    //returns -1 if the sprite has no clip with this name
+    sf::Int16 getClipId(const std::string& name) const;
 
 private:
 
     sf::Sprite m_sprite;
-    sf::Texture m_normalMap;
+    Resource::Handle<sf::Texture> m_texture;
+    Resource::Handle<sf::Texture> m_normalMap;
     sf::Shader* m_shader;
     sf::Vector2i m_frameSize;
     sf::IntRect m_subRect;
@@ -121,7 +104,7 @@ private:
     bool m_loop;
     bool m_playing;
 
-    std::vector<Animation> m_animations;
+    const AnimationClipSet* m_clipSet;
 
     void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
     void setFrame(sf::Uint8 frame);
@@ -0,0 +1,86 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//process wide cache of animation data parsed from .cra files. each file
+//is parsed once and its clips shared by every sprite which uses it
+
+#ifndef ANIMATION_LIBRARY_H_
+#define ANIMATION_LIBRARY_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct Animation
+{
+    friend class AnimatedSprite;
+    Animation(const std::string& name, sf::Int16 begin, sf::Int16 end, bool loop = true)
+        : m_name(name), m_startFrame(begin), m_endFrame(end), m_loop(loop){}
+
+    const std::string& getName() const
+    {
+        return m_name;
+    }
+
+private:
+    std::string m_name;
+    sf::Int16 m_startFrame;
+    sf::Int16 m_endFrame;
+    bool m_loop;
+};
+
+//all the properties loaded from a single .cra file. clip IDs are
+//indices into the clips vector, in the order they appear in the file
+struct AnimationClipSet final
+{
+    AnimationClipSet() : frameCount(0u), frameRate(0.f){}
+
+    std::vector<Animation> clips;
+    std::unordered_map<std::string, sf::Int16> clipIds;
+    sf::Uint8 frameCount;
+    sf::Vector2i frameSize;
+    float frameRate;
+    std::string texturePath;
+    std::string normalMapPath;
+
+    //returns -1 if no clip with the given name exists
+    sf::Int16 getClipId(const std::string& name) const;
+};
+
+namespace AnimationLibrary
+{
+    //loads and parses the file on first request. returned references
+    //remain valid for the lifetime of the program
+    const AnimationClipSet& get(const std::string& path);
+    //parses a file without caching it. used by get()
+    void parse(const std::string& path, AnimationClipSet& clipSet);
+}
+
+#endif //ANIMATION_LIBRARY_H_
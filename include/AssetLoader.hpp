@@ -0,0 +1,86 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//decodes images and sounds as jobs on the job system. decoded images are
+//uploaded to the texture resource in batches by the constructing thread
+
+#ifndef ASSET_LOADER_H_
+#define ASSET_LOADER_H_
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+class TextureResource;
+class JobSystem;
+class AssetLoader final : private sf::NonCopyable
+{
+public:
+    struct Manifest
+    {
+        std::vector<std::string> textures;
+        std::vector<std::string> sounds;
+    };
+
+    //blocks until all textures in the manifest are uploaded and all sounds
+    //decoded. progress is called from this thread with a value 0 - 1
+    AssetLoader(const Manifest& manifest, TextureResource& tr, JobSystem& jobSystem, std::function<void(float)> progress = nullptr);
+    ~AssetLoader() = default;
+
+    //moves a decoded sound buffer out of the loader. returns nullptr
+    //if the path wasn't in the manifest, failed or was already taken
+    std::unique_ptr<sf::SoundBuffer> takeSound(const std::string& path);
+
+private:
+    struct Job
+    {
+        Job(const std::string& p, bool t) : path(p), texture(t), loaded(false){}
+        std::string path;
+        bool texture;
+        bool loaded;
+        sf::Image image;
+        std::unique_ptr<sf::SoundBuffer> sound;
+    };
+    std::vector<Job> m_jobs;
+    std::atomic<std::size_t> m_decodedCount;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::size_t> m_decodedTextures; //waiting for upload
+
+    void decode(std::size_t index);
+};
+
+#endif //ASSET_LOADER_H_
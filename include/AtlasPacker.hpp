@@ -0,0 +1,71 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//packs rectangles into a fixed size area using the skyline bottom-left method.
+//used to combine multiple textures into a single atlas at load time
+
+#ifndef ATLAS_PACKER_H_
+#define ATLAS_PACKER_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+
+class AtlasPacker final
+{
+public:
+    explicit AtlasPacker(const sf::Vector2u& maxSize, sf::Uint32 padding = 2u);
+    ~AtlasPacker() = default;
+
+    //attempts to find space for a rectangle of given size. returns false
+    //if there is no room left, else position contains the top left corner
+    bool insert(const sf::Vector2u& size, sf::Vector2u& position);
+    //returns the smallest area which contains all inserted rectangles
+    const sf::Vector2u& getUsedSize() const;
+    void clear();
+
+private:
+    struct SkylineNode
+    {
+        SkylineNode(sf::Int32 x, sf::Int32 y, sf::Int32 w)
+            : x(x), y(y), width(w){}
+        sf::Int32 x;
+        sf::Int32 y;
+        sf::Int32 width;
+    };
+
+    sf::Vector2i m_maxSize;
+    sf::Int32 m_padding;
+    sf::Vector2u m_usedSize;
+    std::vector<SkylineNode> m_skyline;
+
+    bool fits(std::size_t index, sf::Int32 width, sf::Int32 height, sf::Int32& y) const;
+    void addLevel(std::size_t index, sf::Int32 x, sf::Int32 y, sf::Int32 width, sf::Int32 height);
+};
+
+#endif //ATLAS_PACKER_H_
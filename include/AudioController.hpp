@@ -32,6 +32,7 @@ source distribution.
 
 #include <Observer.hpp>
 #include <SoundPlayer.hpp>
+#include <AssetLoader.hpp>
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Clock.hpp>
@@ -42,19 +43,28 @@ class AudioController final : private sf::NonCopyable, public Observer
 public:
 
 
-    AudioController();
+    //a disabled controller loads and plays nothing, so that
+    //the audio device is never opened when running headless
+    AudioController(AssetLoader& assetLoader, bool enabled = true);
     ~AudioController() = default;
 
     void update();
     void onNotify(Subject& s, const Event& evt) override;
-    void loadTheme(const std::string& theme);
+    void loadTheme(const std::string& theme, AssetLoader& assetLoader);
+
+    //adds the sound files used by the controller and the given theme to the manifest
+    static void listAssets(const std::string& theme, AssetLoader::Manifest& manifest);
 
 private:
+    bool m_enabled;
     SoundPlayer m_soundPlayer;
 
     sf::Int32 m_randomCount;
     float m_randomTime;
     sf::Clock m_randomClock;
+
+    static std::vector<std::string> getThemeFiles(const std::string& theme);
+    void cacheSound(SoundPlayer::AudioId id, const std::string& path, AssetLoader& assetLoader);
 };
 
 #endif //AUDIO_CONTROLLER_H_
\ No newline at end of file
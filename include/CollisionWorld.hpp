@@ -44,6 +44,7 @@ source distribution.
 
 class Node;
 class BodyBehaviour;
+class JobSystem;
 class CollisionWorld final : sf::NonCopyable
 {
 public:
@@ -142,7 +143,7 @@ public:
         float m_length;
     };
 
-    explicit CollisionWorld(float gravity);
+    CollisionWorld(float gravity, JobSystem& jobSystem);
     ~CollisionWorld() = default;
 
     Body* addBody(Body::Type type, const sf::Vector2f& size);
@@ -155,6 +156,9 @@ private:
 
     std::vector<Body::Ptr> m_bodies;
     std::set<CollisionPair> m_collisions;
+    //pairs found by each body's broad phase job, merged into the set afterwards
+    std::vector<std::vector<CollisionPair>> m_bodyCollisions;
+    JobSystem& m_jobSystem;
 
     std::vector<Constraint> m_constraints;
 
@@ -30,15 +30,42 @@ source distribution.
 #ifndef FILE_SYS_H_
 #define FILE_SYS_H_
 
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Config.hpp>
+
 #include <string>
 #include <vector>
 
 class FileSystem final
 {
 public:
+    //read only view of a file mapped into memory. the
+    //data is valid for the lifetime of the object
+    class MappedFile final : private sf::NonCopyable
+    {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        bool valid() const;
+        const char* data() const;
+        std::size_t size() const;
+
+    private:
+        const char* m_data;
+        std::size_t m_size;
+#ifdef _WIN32
+        void* m_file;
+        void* m_mapping;
+#endif //_WIN32
+    };
 
     static std::vector<std::string> listFiles(std::string path);
     static std::string getFileExtension(const std::string& path);
+    //returns 0 if the file doesn't exist
+    static sf::Uint64 getModifiedTime(const std::string& path);
+    //returns 0 if the file doesn't exist
+    static sf::Uint64 getFileSize(const std::string& path);
 
 private:
 
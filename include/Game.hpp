@@ -35,6 +35,9 @@ source distribution.
 #include <ShaderResource.hpp>
 #include <Music.hpp>
 #include <Console.hpp>
+#include <TextBatch.hpp>
+#include <JobSystem.hpp>
+#include <Profiler.hpp>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
@@ -56,10 +59,16 @@ public:
             vSync           (true){}
     };
 
-    Game();
+    //a headless game opens no window or audio device, and only
+    //runs the simulation with runHeadless()
+    explicit Game(bool headless = false);
     ~Game() = default;
 
     void run();
+    //simulates the given number of ticks on a map as fast as possible then
+    //prints timing statistics. returns non-zero if the map was not found
+    int runHeadless(const std::string& map, sf::Uint32 tickCount);
+    bool isHeadless() const;
     void pause();
     void resume();
 
@@ -69,12 +78,19 @@ public:
     TextureResource& getTextureResource();
     ShaderResource& getShaderResource();
     Console& getConsole();
+    JobSystem& getJobSystem();
 
     MusicPlayer& getMusicPlayer();
 
     const VideoSettings& getVideoSettings() const;
 
+    //fraction of a simulation tick elapsed since the last update, used
+    //to interpolate between the previous and current simulation states
+    float getInterpolationAlpha() const;
+    float getTickTime() const;
+
 private: 
+    bool m_headless;
     VideoSettings m_videoSettings;
 
     sf::RenderWindow m_renderWindow;
@@ -85,14 +101,25 @@ private:
     ShaderResource m_shaderResource;
 
     MusicPlayer m_musicPlayer;
+    JobSystem m_jobSystem;
 
     Console m_console;
     StateStack m_stateStack;
 
 
-    sf::Text m_fpsText;
+    TextBatch m_fpsText;
+    sf::Uint32 m_fpsTextId;
     bool m_showFps;
 
+#ifdef CRUSH_PROFILER
+    Profiler::Overlay m_profilerOverlay;
+    bool m_showProfiler;
+    sf::Uint32 m_profilerFrameCount;
+#endif //CRUSH_PROFILER
+
+    float m_interpolationAlpha;
+    float m_tickTime; //can be changed with set_tick_rate
+
     void handleEvents();
     std::function<void(float)> update;
     void updateGame(float dt);
@@ -38,6 +38,14 @@ source distribution.
 #include <MapController.hpp>
 #include <ShaderResource.hpp>
 #include <AudioController.hpp>
+#include <AssetLoader.hpp>
+#include <Map.hpp>
+#include <RenderSnapshot.hpp>
+#include <TaskGraph.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class GameState final : public State
 {
@@ -53,6 +61,14 @@ private:
 
     TextureResource& m_textureResource;
     ShaderResource& m_shaderResource;
+    //ticks are run directly by update() with no
+    //loading screen, audio, snapshots or drawing
+    bool m_headless;
+
+    //these must be initialised before the controllers
+    //so their assets are ready when they are constructed
+    Map m_map;
+    AssetLoader m_assetLoader;
 
     Scene m_scene;
     CommandStack m_commandStack;
@@ -69,7 +85,38 @@ private:
     void addNpc(const sf::Vector2f& position, const sf::Vector2f& size);
     void addMapBody(const Map::Node& n);
 
+    AssetLoader::Manifest preloadAssets();
+
     std::vector<std::string> m_consoleCommands;
+    //time since the scene was last simulated, so that nothing is
+    //interpolated while the game is paused
+    sf::Clock m_tickClock;
+
+    //the simulation runs a tick on its own thread while the last completed
+    //tick is drawn from the front snapshot. the two are swapped by update()
+    RenderSnapshot m_snapshots[2];
+    RenderSnapshot* m_frontSnapshot;
+    RenderSnapshot* m_backSnapshot;
+    bool m_gameOver;
+
+    std::thread m_simThread;
+    std::mutex m_simMutex;
+    std::condition_variable m_simCondition;
+    bool m_tickPending;
+    bool m_quitSimulation;
+    float m_tickDt;
+
+    //subsystems are updated by the graph, which runs
+    //those with no conflicting data at the same time
+    TaskGraph m_taskGraph;
+    void buildTaskGraph();
+
+    void simulate(float dt);
+    void buildSnapshot(RenderSnapshot& snapshot) const;
+    void runSimulation();
+    //anything touching the simulation from the main thread must wait for this
+    void waitForTick();
+
     void registerConsoleCommands();
     void unregisterConsoleCommands();
 
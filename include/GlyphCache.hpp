@@ -0,0 +1,69 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//sf::Font rasterises glyphs the first time they are requested, which uploads
+//to the font's page texture mid frame. this prewarms known glyph sets and
+//records any glyph which is requested afterwards without being prewarmed
+
+#ifndef GLYPH_CACHE_H_
+#define GLYPH_CACHE_H_
+
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+
+namespace sf
+{
+    class Font;
+}
+
+namespace GlyphCache
+{
+    struct Range final
+    {
+        sf::Uint32 charSize;
+        sf::Uint32 first; //inclusive
+        sf::Uint32 last; //inclusive
+        bool bold;
+    };
+
+    //rasterises every glyph in the range so later use doesn't upload
+    void prewarm(const sf::Font& font, const Range& range);
+
+    //text renderers call this for each glyph they request. returns false and
+    //records an upload if the glyph was not already known to be resident
+    bool touch(const sf::Font& font, sf::Uint32 codePoint, sf::Uint32 charSize, bool bold);
+    void touch(const sf::Font& font, const std::string& string, sf::Uint32 charSize, bool bold = false);
+
+    //descriptions of each glyph uploaded after prewarming. this is a copy
+    //as touch() may be called from another thread while it is read
+    std::vector<std::string> getUploads();
+    sf::Uint32 getPrewarmedCount();
+}
+
+#endif //GLYPH_CACHE_H_
@@ -0,0 +1,123 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//work stealing job scheduler shared by the whole game. each worker has its own
+//queue, taking its newest job first and stealing the oldest from other queues
+//when its own is empty. jobs queued by threads which aren't workers share a queue
+
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+class JobSystem final : private sf::NonCopyable
+{
+public:
+    typedef std::function<void()> Job;
+
+    //counts outstanding jobs so that a group of them may be waited on
+    class Counter final : private sf::NonCopyable
+    {
+        friend class JobSystem;
+    public:
+        Counter() : m_count(0u){}
+        bool done() const { return m_count == 0u; }
+    private:
+        std::atomic<sf::Uint32> m_count;
+    };
+
+    struct FrameStats
+    {
+        sf::Uint32 jobsRun = 0u;
+        sf::Uint32 jobsStolen = 0u; //run by a different thread to the one which queued them
+        sf::Uint32 parallelFors = 0u;
+    };
+
+    //0 creates one worker fewer than the number of cores, as the
+    //main thread also runs jobs while it waits on them
+    explicit JobSystem(sf::Uint32 workerCount = 0u);
+    ~JobSystem();
+
+    //fork: queues a job, which is added to the counter until it has run
+    void run(const Job& job, Counter& counter);
+    //join: returns once every job added to the counter has run. the calling
+    //thread runs queued jobs while it waits so this is safe to call from a job
+    void wait(Counter& counter);
+    //calls task once for each index in [0, count), grainSize indices per job,
+    //and returns when all are done
+    void parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t)>& task);
+
+    sf::Uint32 getWorkerCount() const;
+
+    //returns the counters for the frame just finished and starts a new frame
+    FrameStats endFrame();
+    const FrameStats& getLastFrameStats() const;
+
+private:
+    struct Task
+    {
+        Job job;
+        Counter* counter;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> m_threads;
+    //one per worker, followed by the queue shared by all other threads
+    std::vector<std::unique_ptr<Queue>> m_queues;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<sf::Uint32> m_queuedCount;
+    bool m_quit;
+
+    std::atomic<sf::Uint32> m_jobsRun;
+    std::atomic<sf::Uint32> m_jobsStolen;
+    std::atomic<sf::Uint32> m_parallelFors;
+    FrameStats m_lastFrameStats;
+
+    std::size_t getQueueIndex() const;
+    //runs a single job if there is one, returns false if all queues were empty
+    bool runJob(std::size_t queueIndex);
+    void work(std::size_t queueIndex);
+};
+
+#endif //JOB_SYSTEM_H_
\ No newline at end of file
@@ -34,6 +34,12 @@ source distribution.
 
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Vector3.hpp>
+#include <SFML/Graphics/Transform.hpp>
+
+namespace sf
+{
+    class Shader;
+}
 
 class Node;
 class Light final : public Observer
@@ -72,4 +78,24 @@ private:
     Node* m_node;
 };
 
+//the lighting uniforms shared by all scene shaders. these are gathered
+//during the simulation tick and only sent to the shaders when drawing
+struct LightUniforms final
+{
+    sf::Vector3f sunDirection;
+    sf::Vector3f sunColour;
+    sf::Vector3f ambientColour;
+
+    //sfml doesn't support array uniforms so this is fudged by using the
+    //underlying array of the transform class
+    sf::Transform positionsFirst;
+    sf::Transform positionsSecond;
+    sf::Transform coloursFirst;
+    sf::Transform coloursSecond;
+    sf::Vector3f inverseRangesFirst;
+    sf::Vector3f inverseRangesSecond;
+
+    void apply(sf::Shader& shader) const;
+};
+
 #endif // LIGHT_H_
\ No newline at end of file
@@ -35,6 +35,7 @@ source distribution.
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Config.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
 
 #include <Scene.hpp>
 
@@ -70,6 +71,8 @@ public:
     const sf::Color& getSunlightColour() const;
 
     const std::vector<Node>& getNodes() const;
+    //area covered by the solid and water nodes
+    sf::FloatRect getBounds() const;
 
     const sf::Vector2f& getPlayerOneSpawn() const;
     const sf::Vector2f& getPlayerTwoSpawn() const;
@@ -38,6 +38,7 @@ source distribution.
 #include <AnimatedSprite.hpp>
 #include <WaterDrawable.hpp>
 #include <SpriteSheet.hpp>
+#include <AssetLoader.hpp>
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Vector2.hpp>
@@ -50,6 +51,7 @@ source distribution.
 #include <memory>
 
 class Map;
+class JobSystem;
 class MapController final : private sf::NonCopyable, public Observer
 {
 public:
@@ -67,10 +69,16 @@ public:
         Bird
     };
 
-    MapController(CommandStack& cs, TextureResource& tr, ShaderResource& sr);
+    MapController(CommandStack& cs, TextureResource& tr, ShaderResource& sr, JobSystem& jobSystem);
     ~MapController() = default;
 
+    //adds the textures used by the controller and the given map to the manifest
+    static void listAssets(const Map& map, AssetLoader::Manifest& manifest);
+
+    //spawns items and details. this may add nodes to the scene
     void update(float dt);
+    //animates sprites and water, which only touches the map drawables
+    void updateDrawables(float dt);
 
     void setSpawnFunction(std::function<void(const Map::Node&)>& func);
     void loadMap(const Map& map);
@@ -96,6 +104,7 @@ private:
 
     TextureResource& m_textureResource;
     ShaderResource& m_shaderResource;
+    JobSystem& m_jobSystem;
     AnimatedSprite m_itemSprite;
     AnimatedSprite m_backgroundSprite;
     AnimatedSprite m_hatSprite;
@@ -125,13 +134,22 @@ private:
 
         void addPart(const sf::Vector2f& position, const sf::Vector2f& size, const std::string& textureName);
         void addSprite(const std::string& textureName, const SpriteSheet::Quad& frame);
+        //combines sprite sheet textures into a single diffuse / normal atlas pair
+        //so that the layer can be drawn in as few calls as possible. sheets which
+        //don't fit are loaded as separate textures. must be called once all sprites are added
+        void packAtlas(JobSystem& jobSystem);
         void buildShadow(sf::Shader& blurShader);
     private:
         struct LayerData
         {
-            sf::Texture diffuseTexture;
-            sf::Texture normalTexture;
+            LayerData() : packable(false){}
+            Resource::Handle<sf::Texture> diffuseTexture;
+            Resource::Handle<sf::Texture> normalTexture;
             sf::VertexArray vertexArray;
+            //sprite sheets are loaded when packing so we only store the paths until then
+            std::string diffusePath;
+            std::string normalPath;
+            bool packable;
         };
 
         sf::Shader& m_shader;
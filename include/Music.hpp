@@ -34,6 +34,7 @@ source distribution.
 #include <SFML/Audio/Music.hpp>
 
 #include <string>
+#include <memory>
 
 class MusicPlayer final : private sf::NonCopyable
 {
@@ -50,7 +51,8 @@ public:
 private:
 
     float m_volume;
-    sf::Music m_music;
+    //created on first use, as this opens the audio device
+    std::unique_ptr<sf::Music> m_music;
 };
 
 
@@ -47,7 +47,8 @@ source distribution.
 
 class Scene;
 class Light;
-class Node final : public sf::Transformable, public sf::Drawable, private sf::NonCopyable, public Subject, public Observer
+class RenderSnapshot;
+class Node final : public sf::Transformable, private sf::NonCopyable, public Subject, public Observer
 {
     friend class CollisionWorld::Body;
 public:
@@ -89,6 +90,13 @@ public:
 
     void raiseEvent(const Event& evt);
 
+    //copies the current transform of this node and its children to the
+    //previous transform. called at the start of each simulation tick
+    void storeTransform();
+    //adds this node and its children to a snapshot with their previous
+    //and current world transforms, so they may be interpolated when drawn
+    void snapshot(RenderSnapshot& snapshot, sf::Transform previous, sf::Transform current) const;
+
 private:
     std::vector<Ptr> m_children;
     Node* m_parent;
@@ -103,9 +111,12 @@ private:
     Category::Type m_category;
 
     sf::BlendMode m_blendMode;
-    void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
-    void drawSelf(sf::RenderTarget& rt, sf::RenderStates states) const;
-    void drawChildren(sf::RenderTarget& rt, sf::RenderStates states) const;
+
+    sf::Vector2f m_previousPosition;
+    float m_previousRotation;
+    sf::Vector2f m_previousScale;
+    bool m_hasPreviousTransform;
+    sf::Transform getPreviousTransform() const;
 };
 
 #endif //NODE_H_
\ No newline at end of file
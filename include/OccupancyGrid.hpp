@@ -0,0 +1,85 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//coarse grid marking which parts of the world are solid or water so
+//that large numbers of particles can test against the map cheaply
+
+#ifndef OCCUPANCY_GRID_H_
+#define OCCUPANCY_GRID_H_
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Config.hpp>
+
+#include <vector>
+
+class WaterDrawable;
+class OccupancyGrid final : private sf::NonCopyable
+{
+public:
+    enum Cell : sf::Uint8
+    {
+        Empty = 0u,
+        Solid,
+        Water
+    };
+
+    OccupancyGrid(const sf::FloatRect& worldBounds, float cellSize);
+    ~OccupancyGrid() = default;
+
+    //marks all cells overlapped by the given area
+    void addSolid(const sf::FloatRect& area);
+    void addWater(const sf::FloatRect& area, WaterDrawable& drawable);
+    void clear();
+    //clears the grid and sizes it to cover the given area
+    void resize(const sf::FloatRect& worldBounds);
+
+    //positions outside the world bounds are always empty
+    Cell getCell(float x, float y) const;
+    //splashes the surface of the water body containing the given
+    //position. NOT thread safe as it modifies the water drawable
+    void splash(float x, float y, float speed);
+
+private:
+    struct WaterBody
+    {
+        sf::FloatRect area;
+        WaterDrawable* drawable;
+    };
+
+    sf::FloatRect m_bounds;
+    float m_cellSize;
+    float m_inverseCellSize;
+    sf::Uint32 m_width;
+    sf::Uint32 m_height;
+    std::vector<sf::Uint8> m_cells;
+    std::vector<WaterBody> m_waterBodies;
+
+    void fill(const sf::FloatRect& area, Cell cell);
+};
+
+#endif //OCCUPANCY_GRID_H_
@@ -31,6 +31,7 @@ source distribution.
 #define PARTICLE_CONTROLLER_H_
 
 #include <Observer.hpp>
+#include <OccupancyGrid.hpp>
 #include <Particles.hpp>
 #include <Resource.hpp>
 #include <ShaderResource.hpp>
@@ -39,24 +40,55 @@ source distribution.
 #include <SFML/Graphics/Drawable.hpp>
 
 #include <vector>
+#include <map>
+#include <memory>
 
+class RenderSnapshot;
+class JobSystem;
 class ParticleController final : public Observer, private sf::NonCopyable, public sf::Drawable
 {
 public:
-    ParticleController(TextureResource& tr, ShaderResource& sr);
+    ParticleController(TextureResource& tr, ShaderResource& sr, JobSystem& jobSystem);
     ~ParticleController() = default;
 
     void update(float dt);
 
     void onNotify(Subject& s, const Event& evt) override;
 
+    //static map geometry particles may collide with
+    OccupancyGrid& getCollisionGrid();
+
+    sf::Uint32 getLiveParticleCount() const;
+    sf::Uint32 getEmitterCount() const;
+    sf::Uint32 getActiveEmitterCount() const;
+
+    //adds a copy of every visible system to the snapshot
+    void snapshot(RenderSnapshot& snapshot) const;
+
 private:
-    std::vector<ParticleSystem> m_systems;
-    TextureResource& m_textureResource;
-    ShaderResource& m_shaderResource;
+    //systems are observers of nodes so must not move in memory
+    std::vector<std::unique_ptr<ParticleSystem>> m_systems;
+    std::map<Particle::Type, std::vector<ParticleSystem*>> m_idleSystems;
+    std::vector<ParticleSystem*> m_activeSystems; //in the order they were started
+    sf::Uint32 m_liveParticleCount;
+    JobSystem& m_jobSystem;
+    OccupancyGrid m_collisionGrid;
+
+    //systems are added on the simulation thread, so textures and
+    //shaders are looked up once here rather than from the caches
+    struct SystemResources final
+    {
+        const sf::Texture* texture = nullptr;
+        const sf::Texture* normalMap = nullptr;
+        sf::Shader* shader = nullptr;
+    };
+    std::map<Particle::Type, SystemResources> m_systemResources;
 
     ParticleSystem& addSystem(Particle::Type type);
     ParticleSystem& findSystem(Particle::Type type);
+    //starts a system within the global particle budget
+    void startSystem(ParticleSystem& ps, sf::Uint8 releaseCount = 1u, float duration = 0.f);
+    bool cullCosmeticSystems();
     void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
 };
 
@@ -32,17 +32,16 @@ source distribution.
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Clock.hpp>
 #include <SFML/Graphics/Color.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
-#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Drawable.hpp>
 
 #include <Affectors.hpp>
 #include <Observer.hpp>
 
-#include <deque>
 #include <functional>
 #include <vector>
 
-struct Particle final : public sf::Transformable
+struct Particle final
 {    
     enum class Type
     {
@@ -54,18 +53,53 @@ struct Particle final : public sf::Transformable
         Smoke,
         Sparkle
     };
+};
 
-    //sf::Vector2f position;
-    sf::Vector2f velocity;
-    sf::Color colour;
-    float lifetime = 0.f;
+//particle properties stored as packed arrays. live particles
+//occupy the first count elements, dead ones are swapped out
+struct ParticleData final
+{
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> scaleX;
+    std::vector<float> scaleY;
+    std::vector<float> rotation; //degrees
+    std::vector<float> lifetime;
+    std::vector<sf::Color> colour;
+    std::size_t count = 0u;
+
+    void setCapacity(std::size_t capacity);
+    std::size_t getCapacity() const;
+    //moves the last live particle into the given index
+    void remove(std::size_t index);
 };
 
 class Node;
+class OccupancyGrid;
 class ParticleSystem final : public sf::Drawable, public Observer
 {
 public:
-    typedef std::function<void(Particle& p, float dt)> Affector;
+    //runtime affectors are called once per particle. prefer an
+    //AffectorPipeline for anything known at compile time
+    typedef std::function<void(ParticleData& data, std::size_t index, float dt)> Affector;
+    typedef std::function<void(ParticleData& data, float dt)> Pipeline;
+
+    //what happens to a particle when it enters a solid cell.
+    //particles entering water always die
+    enum class CollisionMode
+    {
+        None,
+        Stick,
+        Bounce,
+        Die
+    };
+
+    struct WaterHit final
+    {
+        float x, y, speed;
+    };
 
     explicit ParticleSystem(Particle::Type type);
     ~ParticleSystem() = default;
@@ -84,23 +118,55 @@ public:
     void setInitialVelocity(const sf::Vector2f& vel);
     void setRandomInitialVelocity(const std::vector<sf::Vector2f>& randValues);
     void setEmitRate(float rate);
+    //maximum number of live particles. emission stops when full
+    void setCapacity(sf::Uint32 capacity);
+    //grid must outlive the system. nullptr disables collision
+    void setCollisionGrid(const OccupancyGrid* grid, CollisionMode mode);
+    //when true particles entering water are recorded as hits
+    void setSplashWater(bool splash);
+    //water hits recorded by the last updateParticles(). splashing is
+    //left to the caller as water drawables are shared between systems
+    const std::vector<WaterHit>& getWaterHits() const;
 
     void addAffector(Affector& a);
     template <typename T>
     void addAffector(T& affector);
+    template <typename... Affectors>
+    void setAffectorPipeline(const AffectorPipeline<Affectors...>& pipeline);
 
     void start(sf::Uint8 releaseCount = 1, float duration = 0.f);
     bool started() const;
     void stop();
+    //removes all live particles without stopping emission
+    void clear();
     void update(float dt);
+    //update() is split so that emission, which follows the parent node and
+    //draws random numbers, can run serially before particles are simulated.
+    //updateParticles() only touches this system so may run on any thread.
+    //emits at most allowance particles and returns how many were emitted
+    sf::Uint32 updateEmitter(float dt, sf::Uint32 allowance);
+    void updateParticles(float dt);
     
     Particle::Type getType() const;
     sf::Uint32 getParticleCount() const;
 
+    //copy of the live particle quads which can be drawn while the system updates
+    struct Snapshot final : public sf::Drawable
+    {
+        std::vector<sf::Vertex> vertices;
+        const sf::Texture* texture = nullptr;
+        const sf::Texture* normalMap = nullptr;
+        sf::Shader* shader = nullptr;
+        sf::BlendMode blendMode;
+    private:
+        void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
+    };
+    void getSnapshot(Snapshot& snapshot) const;
+
     void setNode(Node& n);
     void onNotify(Subject&, const Event&) override;
 private:
-    std::deque<Particle> m_particles;
+    ParticleData m_particles;
     sf::Texture* m_texture;
     sf::Texture* m_normalMap;
     sf::Color m_colour;
@@ -119,9 +185,14 @@ private:
     float m_accumulator;
     
     std::vector<Affector> m_affectors;
+    Pipeline m_pipeline;
+
+    const OccupancyGrid* m_collisionGrid;
+    CollisionMode m_collisionMode;
+    bool m_splashWater;
+    std::vector<WaterHit> m_waterHits;
 
-    mutable sf::VertexArray m_vertices;
-    mutable bool m_needsUpdate;
+    std::vector<sf::Vertex> m_vertices; //four per particle, written by update
 
     sf::Clock m_durationClock;
     float m_duration;
@@ -132,10 +203,10 @@ private:
 
     Node* m_parent;
 
-    void emit(float dt);
+    sf::Uint32 emit(float dt, sf::Uint32 allowance);
     void addParticle(const sf::Vector2f& position);
-    void addVertex(const sf::Vector2f& position, float u, float v, const sf::Color& colour)const;
-    void updateVertices() const;
+    void collide(float dt);
+    void updateVertices();
 
     void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
 };
@@ -143,8 +214,14 @@ private:
 template <typename T>
 void ParticleSystem::addAffector(T& affector)
 {
-    Affector a = std::bind(affector, std::placeholders::_1, std::placeholders::_2);
+    Affector a = std::bind(affector, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
     m_affectors.push_back(a);
 }
 
+template <typename... Affectors>
+void ParticleSystem::setAffectorPipeline(const AffectorPipeline<Affectors...>& pipeline)
+{
+    m_pipeline = pipeline;
+}
+
 #endif //PARTICLES_H_
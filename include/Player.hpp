@@ -107,13 +107,18 @@ private:
     sf::Vector2f m_currentPosition;
     sf::Vector2f m_size;
 
-    sf::Texture m_normalTexture;
     AnimatedSprite m_sprite;
     AnimatedSprite m_powerupSprite;
 
     bool m_flashSprite;
     bool m_hasHat;
 
+    //clips from the sprite's animation file, -1 if missing
+    sf::Int16 m_idleClip;
+    sf::Int16 m_runClip;
+    sf::Int16 m_jumpClip;
+    sf::Int16 m_fallClip;
+
     void enable();
     void setSize(const sf::Vector2f& size);
 
@@ -124,6 +129,7 @@ private:
     void doPickUp();
     void doDrop(bool raiseEvent = true);
     void dropHat(bool raiseEvent = true);
+    void playClip(sf::Int16 clipId, const Animation& fallback);
 };
 
 #endif //PLAYER_H_
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//scoped cpu timers aggregated into a per-frame hierarchy. the last few seconds
+//of scopes from every thread are also kept so that hitches can be inspected in
+//chrome://tracing. the macros compile to nothing unless CRUSH_PROFILER is
+//defined, so timers cost nothing otherwise
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <TextBatch.hpp>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef CRUSH_PROFILER
+//times the enclosing scope as a child of the scope in progress on this thread
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+//times the enclosing scope at the top of the hierarchy. used by jobs, which
+//may be run on any thread while it waits inside some other scope
+#define PROFILE_TASK(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name, true)
+#define PROFILE_END_FRAME() Profiler::endFrame()
+//labels the calling thread in trace captures
+#define PROFILE_THREAD_NAME(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_TASK(name)
+#define PROFILE_END_FRAME()
+#define PROFILE_THREAD_NAME(name)
+#endif //CRUSH_PROFILER
+
+//allocations are counted by replacing the global operator new, and are
+//attributed to the innermost profiler scope on the allocating thread
+#if defined(CRUSH_TRACK_ALLOCATIONS) && !defined(CRUSH_PROFILER)
+#error CRUSH_TRACK_ALLOCATIONS requires CRUSH_PROFILER
+#endif
+
+namespace sf
+{
+    class Font;
+}
+
+namespace Profiler
+{
+    class Scope final : private sf::NonCopyable
+    {
+    public:
+        explicit Scope(const char* name, bool topLevel = false);
+        ~Scope();
+    private:
+        std::size_t m_node;
+        std::chrono::high_resolution_clock::time_point m_start;
+    };
+
+    struct Stats final
+    {
+        std::string path;
+        std::string name;
+        sf::Uint32 depth = 0u;
+        float average = 0.f; //milliseconds per frame
+        float max = 0.f;
+        float last = 0.f;
+        float calls = 0.f; //average per frame
+        float allocations = 0.f; //average per frame
+        float allocationBytes = 0.f;
+    };
+
+    void setThreadName(const std::string& name);
+
+    //closes the current frame and adds it to the history. if the frame took
+    //longer than the spike threshold a trace is written to spike_<frame>.json
+    void endFrame();
+    std::size_t getFrameCount();
+    float getAverageFrameTime(std::size_t frameCount);
+    //rolling statistics of every scope over the last frameCount frames, with
+    //children following their parents
+    std::vector<Stats> getStats(std::size_t frameCount);
+    //writes the last frameCount frames with one row per frame and a column per scope
+    bool writeCsv(const std::string& path, std::size_t frameCount);
+    //writes the last few seconds of scopes from all threads in the trace event
+    //format read by chrome://tracing
+    bool writeTrace(const std::string& path);
+    //frames longer than this many milliseconds write a trace. 0 disables
+    void setSpikeThreshold(float milliseconds);
+    float getSpikeThreshold();
+
+    //installed as the allocation hook callback. safe to call from any
+    //thread and before the profiler is initialised
+    void recordAllocation(std::size_t bytes);
+    //once warmupFrames have passed any frame in which the given scopes, or
+    //their children, allocate will be reported and abort the program. an
+    //empty list disables the check
+    void setAllocationAssert(const std::vector<std::string>& paths, std::size_t warmupFrames);
+    sf::Uint32 getLastFrameAllocations();
+
+    //draws a bar for each scope, indented by depth, showing its average
+    //time. the darker end of each bar shows the worst frame
+    class Overlay final : public sf::Drawable, private sf::NonCopyable
+    {
+    public:
+        explicit Overlay(const sf::Font& font);
+        ~Overlay() = default;
+
+        //rebuilds the bars from the rolling statistics
+        void update(std::size_t frameCount = 60u);
+
+    private:
+        TextBatch m_text;
+        std::vector<sf::Uint32> m_rows;
+        sf::VertexArray m_bars;
+
+        void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
+    };
+}
+
+#endif //PROFILER_H_
\ No newline at end of file
@@ -0,0 +1,111 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//immutable copy of everything drawn by the game state, built at the end of each
+//simulation tick so that drawing never needs to read the simulation objects
+
+#ifndef RENDER_SNAPSHOT_H_
+#define RENDER_SNAPSHOT_H_
+
+#include <Light.hpp>
+#include <AnimatedSprite.hpp>
+#include <WaterDrawable.hpp>
+#include <Particles.hpp>
+#include <TextBatch.hpp>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+class RenderSnapshot final : public sf::Drawable, private sf::NonCopyable
+{
+public:
+    RenderSnapshot();
+    ~RenderSnapshot() = default;
+
+    //empties the snapshot but keeps its copies allocated for reuse
+    void clear();
+
+    void setView(const sf::View& view);
+    void setLights(const LightUniforms& lights, const std::vector<sf::Shader*>& shaders);
+    //sprites and water are copied, anything else is assumed to be static
+    //and must outlive the snapshot. drawables used by more than one node
+    //are only copied once
+    void addDrawable(const sf::Drawable& drawable, const sf::Transform& previous, const sf::Transform& current, sf::BlendMode blendMode);
+    void addParticles(const ParticleSystem& particleSystem);
+    void setText(const TextBatch& textBatch);
+
+    //fraction of a tick between the previous and current transforms to draw
+    void setInterpolationAlpha(float alpha);
+    std::size_t getDrawableCount() const;
+
+private:
+    enum class Type
+    {
+        Sprite,
+        Water,
+        Static
+    };
+
+    struct Item final
+    {
+        Type type;
+        std::size_t index;
+        sf::Transform previous;
+        sf::Transform current;
+        sf::BlendMode blendMode;
+    };
+
+    sf::View m_view;
+    LightUniforms m_lights;
+    std::vector<sf::Shader*> m_shaders;
+
+    std::vector<Item> m_items;
+    std::unordered_map<const sf::Drawable*, std::size_t> m_copyIndices;
+
+    //copies are pooled and assigned over on the next tick
+    std::vector<AnimatedSprite> m_sprites;
+    std::size_t m_spriteCount;
+    std::vector<WaterDrawable::Snapshot> m_water;
+    std::size_t m_waterCount;
+    std::vector<const sf::Drawable*> m_statics;
+    std::vector<ParticleSystem::Snapshot> m_particles;
+    std::size_t m_particleCount;
+    TextBatch::Snapshot m_text;
+    //text is laid out here when drawn, as only the main thread may use the font
+    mutable std::unique_ptr<TextBatch> m_textBatch;
+
+    float m_interpolationAlpha;
+
+    void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
+};
+
+#endif //RENDER_SNAPSHOT_H_
\ No newline at end of file
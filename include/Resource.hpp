@@ -36,16 +36,71 @@ source distribution.
 #include <SFML/Graphics/Font.hpp>
 #include <memory>
 #include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Resource
+{
+    enum class Status
+    {
+        Loaded,
+        Fallback //failed to load, resource is the error handle
+    };
+
+    //ref counted handle to a cached resource. copying a handle is cheap
+    //and shares the underlying resource rather than duplicating it
+    template <class T>
+    class Handle final
+    {
+    public:
+        Handle() : m_status(Status::Fallback){}
+        explicit Handle(std::shared_ptr<T> resource, Status status = Status::Loaded)
+            : m_resource(resource), m_status(status){}
+
+        T& operator*() const { return *m_resource; }
+        T* operator->() const { return m_resource.get(); }
+        T* get() const { return m_resource.get(); }
+        explicit operator bool() const { return m_resource != nullptr; }
+
+        Status getStatus() const { return m_status; }
+        bool loaded() const { return m_resource && m_status == Status::Loaded; }
+        long useCount() const { return m_resource.use_count(); }
+
+    private:
+        std::shared_ptr<T> m_resource;
+        Status m_status;
+    };
+
+    //frame counter used to record when a resource was last requested
+    inline sf::Uint64& frameCounter()
+    {
+        static sf::Uint64 frame = 0u;
+        return frame;
+    }
+    inline void advanceFrame(){ frameCounter()++; }
+    inline sf::Uint64 currentFrame(){ return frameCounter(); }
+}
 
 template <class T>
 class BaseResource : private sf::NonCopyable
 {
 public:
-    BaseResource()
+    explicit BaseResource(std::size_t budget = 0u)
+        : m_budget(budget), m_residentBytes(0u)
     {
     }
     virtual ~BaseResource(){};
+    //references are not counted, so resources requested
+    //this way are pinned and will never be evicted
     T& get(const std::string& path = "default")
+    {
+        auto handle = getHandle(path);
+        m_resources[path].pinned = true;
+        return *handle;
+    }
+
+    Resource::Handle<T> getHandle(const std::string& path = "default")
     {
         //if we have a valid path check current resources and return if found
         if (!path.empty())
@@ -53,30 +108,115 @@ public:
             auto r = m_resources.find(path);
             if (r != m_resources.end())
             {
-                return *r->second;
+                r->second.lastUsed = Resource::currentFrame();
+                return r->second.handle;
             }
         }
         //else attempt to load from file
-        std::unique_ptr<T> r = std::unique_ptr<T>(new T());
+        std::shared_ptr<T> r = std::make_shared<T>();
         if (path.empty() || !r->loadFromFile(path))
         {
-            m_resources[path] = errorHandle(); //error handle should return message endl
+            return insert(path, Resource::Handle<T>(std::shared_ptr<T>(errorHandle()), Resource::Status::Fallback)); //error handle should return message endl
         }
-        else
+        return insert(path, Resource::Handle<T>(r));
+    }
+
+    //adds a resource loaded elsewhere, such as by the asset loader,
+    //to the cache. replaces any existing resource with the same path
+    Resource::Handle<T> insert(const std::string& path, Resource::Handle<T> handle)
+    {
+        auto& entry = m_resources[path];
+        m_residentBytes -= entry.size;
+        entry.handle = handle;
+        entry.size = sizeOf(*handle, path);
+        entry.lastUsed = Resource::currentFrame();
+        m_residentBytes += entry.size;
+
+        evict();
+        return handle;
+    }
+
+    bool contains(const std::string& path) const
+    {
+        return m_resources.find(path) != m_resources.end();
+    }
+
+    //sets the number of bytes resident resources may use before
+    //unreferenced ones are evicted. 0 disables eviction
+    void setBudget(std::size_t bytes)
+    {
+        m_budget = bytes;
+        evict();
+    }
+    std::size_t getBudget() const { return m_budget; }
+    std::size_t getResidentBytes() const { return m_residentBytes; }
+
+    //removes least recently used resources which are neither pinned nor
+    //referenced by a handle until resident memory is within budget
+    void evict()
+    {
+        while (m_budget > 0 && m_residentBytes > m_budget)
+        {
+            auto oldest = m_resources.end();
+            for (auto r = m_resources.begin(); r != m_resources.end(); ++r)
+            {
+                if (!r->second.pinned && r->second.handle.useCount() == 1
+                    && (oldest == m_resources.end() || r->second.lastUsed < oldest->second.lastUsed))
+                {
+                    oldest = r;
+                }
+            }
+            if (oldest == m_resources.end()) return; //everything is in use
+
+            m_residentBytes -= oldest->second.size;
+            m_resources.erase(oldest);
+        }
+    }
+
+    //one line per resident resource with its size and last use frame
+    std::vector<std::string> listResources() const
+    {
+        std::vector<std::string> list;
+        for (const auto& r : m_resources)
         {
-            m_resources[path] = std::move(r);
+            list.push_back(r.first + ": " + std::to_string(r.second.size / 1024u) + "KB, frame "
+                + std::to_string(r.second.lastUsed) + ", " + std::to_string(r.second.handle.useCount() - 1) + " handles"
+                + (r.second.pinned ? ", pinned" : ""));
         }
-        //TODO - we could check for map size here and flush if over certain size
-        return *m_resources[path];
+        list.push_back(std::to_string(m_resources.size()) + " resources, " + std::to_string(m_residentBytes / 1024u)
+            + "KB of " + ((m_budget > 0) ? std::to_string(m_budget / 1024u) + "KB" : "unlimited"));
+        return list;
     }
+
 protected:
+    struct Entry
+    {
+        Entry() : size(0u), lastUsed(0u), pinned(false){}
+        Resource::Handle<T> handle;
+        std::size_t size;
+        sf::Uint64 lastUsed;
+        bool pinned;
+    };
+
     virtual std::unique_ptr<T> errorHandle() = 0;
+    //approximate memory used by a resource, for budgeting
+    virtual std::size_t sizeOf(const T& resource, const std::string& path) const = 0;
+    const std::map<std::string, Entry>& getResources() const
+    {
+        return m_resources;
+    }
 private:
-    std::map<std::string, std::unique_ptr<T> > m_resources;
+    std::map<std::string, Entry> m_resources;
+    std::size_t m_budget;
+    std::size_t m_residentBytes;
 };
 
 class TextureResource final : public BaseResource<sf::Texture>
 {
+public:
+    //lists the video memory used by cached textures, compared with
+    //the memory which would be used if every handle held a copy
+    std::vector<std::string> getMemoryReport() const;
 private:
     std::unique_ptr<sf::Texture> errorHandle() override
     {
@@ -86,6 +226,10 @@ private:
         t->loadFromImage(i);
         return std::move(t);
     }
+    std::size_t sizeOf(const sf::Texture& t, const std::string&) const override
+    {
+        return t.getSize().x * t.getSize().y * 4u;
+    }
 };
 class ImageResource final : public BaseResource<sf::Image>
 {
@@ -95,6 +239,10 @@ class ImageResource final : public BaseResource<sf::Image>
         i->create(20u, 20u, sf::Color::Green);
         return std::move(i);
     }
+    std::size_t sizeOf(const sf::Image& i, const std::string&) const override
+    {
+        return i.getSize().x * i.getSize().y * 4u;
+    }
 };
 
 class FontResource final : public BaseResource<sf::Font>
@@ -104,6 +252,8 @@ public:
 private:
     sf::Font m_font;
     std::unique_ptr<sf::Font> errorHandle() override;
+    //glyph pages are created on demand, so the file size is the best guess
+    std::size_t sizeOf(const sf::Font& font, const std::string& path) const override;
 };
 
-#endif //RESOURCES_H_
\ No newline at end of file
+#endif //RESOURCES_H_
@@ -37,8 +37,8 @@ source distribution.
 
 #include <set>
 
-
-class Scene final : public sf::Drawable, private sf::NonCopyable, public Observer, public Subject
+class RenderSnapshot;
+class Scene final : private sf::NonCopyable, public Observer, public Subject
 {
 public:
     enum Layer //this sets the order in which the layers are drawn
@@ -80,7 +80,11 @@ public:
 
     void update(float dt);
 
-
+    //stores node transforms at the start of a simulation tick
+    void storeTransforms();
+    //copies everything needed to draw the scene, so that it may
+    //be drawn on another thread while the next tick is simulated
+    void snapshot(RenderSnapshot& snapshot) const;
 
 private:
     std::vector<Node::Ptr> m_children;
@@ -91,11 +95,11 @@ private:
     std::vector<Light> m_lights;
     std::vector<sf::Shader*> m_shaders;
     sf::Vector3f m_ambientColour;
+    LightUniforms m_lightUniforms;
 
     //we want to make sure each node is only entered once
     std::set<Node*> m_deletedList;
 
-    void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
     //delete any nodes waiting
     void flush();
 };
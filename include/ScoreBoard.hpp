@@ -32,6 +32,7 @@ source distribution.
 
 #include <Observer.hpp>
 #include <State.hpp>
+#include <TextBatch.hpp>
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Graphics/Drawable.hpp>
@@ -39,11 +40,11 @@ source distribution.
 
 #include <list>
 
-
+class RenderSnapshot;
 class ScoreBoard final : public Observer, public Subject, public sf::Drawable, private sf::NonCopyable
 {
 public:
-    ScoreBoard(StateStack& stack, State::Context context);
+    explicit ScoreBoard(State::Context context);
     ~ScoreBoard() = default;
 
     void update(float dt);
@@ -52,10 +53,14 @@ public:
 
     void enablePlayer(Category::Type player);
     void setMaxNpcs(sf::Uint8 count);
+    //the scoreboard is updated by the simulation thread so it
+    //leaves pushing the game over state to its owner
+    bool gameOver() const;
+    void snapshot(RenderSnapshot& snapshot) const;
 
 private:
-    StateStack& m_stack;
     State::Context m_context;
+    bool m_gameOver;
 
     sf::Int16 m_playerOneLives;
     sf::Int16 m_playerTwoLives;
@@ -78,6 +83,11 @@ private:
     sf::Uint8 m_spawnedNpcs;
     sf::Uint8 m_deadNpcs;
 
+    TextBatch m_textBatch;
+    sf::Uint32 m_playerOneText;
+    sf::Uint32 m_playerTwoText;
+    sf::Uint32 m_npcText;
+
     void updateText(Category::Type type);
     void updateGameData();
     void disablePlayer(Category::Type player);
@@ -85,10 +95,12 @@ private:
 
     void killstreakMessage();
 
-    class Message final : public sf::Drawable
+    //messages are laid out by the scoreboard's text batch, which
+    //draws them. the text is removed when the message is.
+    class Message final
     {
     public:
-        Message(const std::string& text, const sf::Vector2f& position, const sf::Font& font, bool zoom = false);
+        Message(const std::string& text, const sf::Vector2f& position, TextBatch& textBatch, bool zoom = false);
         Message(const Message& copy) = default;
         ~Message() = default;
 
@@ -96,16 +108,16 @@ private:
 
         void setColour(const sf::Color& c);
         bool stopped() const;
+        sf::Uint32 getTextId() const;
 
     private:
 
         sf::Color m_colour;
         float m_transparency;
         bool m_zoom;
-        sf::Text m_text;
+        TextBatch* m_textBatch;
+        sf::Uint32 m_textId;
         float m_messageSpeed;
-
-        void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
     };
 
     std::list<Message> m_messages;
@@ -30,6 +30,7 @@ source distribution.
 #define SHADER_RESOURCE_H_
 
 #include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
 #include <SFML/Graphics/Shader.hpp>
 
 #include <memory>
@@ -85,10 +86,15 @@ class ShaderResource final : private sf::NonCopyable
 {
 public:
 
-    ShaderResource() = default;
-    ~ShaderResource() = default;
+    //when compile is false shaders are created empty, so
+    //that nothing needs a GL context when running headless
+    explicit ShaderResource(bool compile = true);
+    ~ShaderResource();
 
     sf::Shader& get(Shader::Type type);
+    //compiles every shader type on a background thread with its own
+    //shared context, so get() doesn't stall on compilation later
+    void precompile();
 
     void addBinding(Shader::UniformBinding::Ptr& b);
     void updateBindings();
@@ -97,6 +103,11 @@ private:
     std::map<Shader::Type, Shader::Ptr> m_shaders;
 
     std::vector<Shader::UniformBinding::Ptr> m_uniformBindings;
+
+    bool m_compile;
+    sf::Thread m_compileThread;
+    void compileAll();
+    static Shader::Ptr create(Shader::Type type);
 };
 
 #endif //SHADER_RESOURCE_H_
\ No newline at end of file
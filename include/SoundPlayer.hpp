@@ -37,6 +37,7 @@ source distribution.
 
 #include <map>
 #include <list>
+#include <memory>
 
 class Node;
 class SoundPlayer final : private sf::NonCopyable
@@ -100,17 +101,19 @@ public:
     void setListenerPosition(const sf::Vector2f& position);
     sf::Vector2f getListenerPosition() const;
     void cacheSound(AudioId, const std::string&);
+    void cacheSound(AudioId, std::unique_ptr<sf::SoundBuffer> buffer);
 
     static void setVolume(float volume);
     static float getVolume();
 
 private:
 
-    std::map<AudioId, sf::SoundBuffer> m_buffers;
+    std::map<AudioId, std::unique_ptr<sf::SoundBuffer>> m_buffers;
     std::list<sf::Sound> m_sounds;
     std::list<std::pair<Node*, sf::Sound*>> m_loopedSounds;
 
     void flushSounds();
+    const sf::SoundBuffer& getBuffer(AudioId id);
 };
 
 #endif //SOUND_PLAYER_H_
\ No newline at end of file
@@ -37,13 +37,15 @@ source distribution.
 #include <string>
 #include <array>
 #include <vector>
+#include <unordered_map>
 
 class SpriteSheet final
 {
 public:
     typedef std::array<sf::Vertex, 4u> Quad;
 
-    SpriteSheet(const std::string& path);
+    //when useCache is false the json is always parsed and no cache is written
+    SpriteSheet(const std::string& path, bool useCache = true);
     SpriteSheet(const SpriteSheet& copy) = default;
     //SpriteSheet& operator=(const SpriteSheet& s) = delete;
     //SpriteSheet(SpriteSheet&& s){}
@@ -71,6 +73,13 @@ private:
 
     std::string m_name;
     std::vector<Frame> m_frames;
+    std::unordered_map<std::string, std::size_t> m_frameIndices;
+
+    void parseJson(const std::string& path);
+    //the binary cache is stored next to the json file and is
+    //only used if it was written from the current version of it
+    bool readCache(const std::string& path, sf::Uint64 modifiedTime, sf::Uint64 fileSize);
+    void writeCache(const std::string& path, sf::Uint64 modifiedTime, sf::Uint64 fileSize) const;
 };
 
 #endif //SPRITE_SHEET_H_
\ No newline at end of file
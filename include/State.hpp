@@ -73,6 +73,7 @@ struct GameData
 class StateStack;
 class Game;
 class TextureResource;
+class JobSystem;
 class State
 {
 public:
@@ -83,6 +84,7 @@ public:
         Context(sf::RenderWindow& renderWindow, Game& game, GameData& gd);
         sf::RenderWindow& renderWindow;
         Game& gameInstance;
+        JobSystem& jobSystem; //shared by everything which runs work in parallel
         sf::View defaultView; //automatically updated to correctly letterbox screen
         GameData& gameData;
     };
@@ -103,6 +105,8 @@ protected:
 
     void launchLoadingScreen();    
     void quitLoadingScreen();
+    //progress in the range 0 - 1, displayed by the loading screen
+    void setLoadingProgress(float progress);
 
 private:
 
@@ -112,6 +116,7 @@ private:
     AnimatedSprite m_loadingSprite;
     sf::Text m_loadingText;
     std::atomic<bool> m_threadRunning;
+    std::atomic<float> m_loadingProgress;
     sf::Thread m_loadingThread;
     sf::Clock m_threadClock;
     void updateLoadingScreen();
@@ -0,0 +1,93 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//runs a set of per-tick tasks on the job system. each task declares the data it
+//reads and writes so that tasks which don't conflict may run at the same time
+
+#ifndef TASK_GRAPH_H_
+#define TASK_GRAPH_H_
+
+#include <JobSystem.hpp>
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+
+class TaskGraph final : private sf::NonCopyable
+{
+public:
+    typedef std::function<void(float)> Task;
+
+    explicit TaskGraph(JobSystem& jobSystem);
+    ~TaskGraph() = default;
+
+    //tasks are added in the order they would run one after another. a task waits
+    //for any earlier task which writes something it reads or writes, and for any
+    //earlier task which reads something it writes
+    void addTask(const std::string& name, const Task& task, const std::vector<std::string>& reads, const std::vector<std::string>& writes);
+    //runs every task once, returning when they are all done
+    void run(float dt);
+    //when false tasks run one at a time in the order they were added
+    void setParallel(bool parallel);
+    bool parallel() const;
+
+    //lists each task with its data, dependencies and the time it took
+    //last run, followed by the graph in graphviz dot format
+    std::string dump() const;
+    //the number of times each task has run, with its mean,
+    //worst and total time, and the total for the whole graph
+    std::string report() const;
+
+private:
+    struct Node final
+    {
+        std::string name;
+        Task task;
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+        std::vector<std::size_t> dependencies;
+        std::vector<std::size_t> dependents;
+        std::atomic<sf::Uint32> waitCount;
+        float lastRunTime = 0.f; //milliseconds
+        float maxRunTime = 0.f;
+        double totalRunTime = 0.0;
+        sf::Uint64 runCount = 0u;
+    };
+
+    JobSystem& m_jobSystem;
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    bool m_parallel;
+
+    void runNode(std::size_t index, float dt, JobSystem::Counter& counter);
+    static void recordRunTime(Node& node, float time);
+};
+
+#endif //TASK_GRAPH_H_
\ No newline at end of file
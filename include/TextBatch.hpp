@@ -0,0 +1,139 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//lays out multiple strings sharing a font into one vertex array per
+//character size, so that a whole HUD can be drawn with a single call
+
+#ifndef TEXT_BATCH_H_
+#define TEXT_BATCH_H_
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace sf
+{
+    class Font;
+}
+
+class TextBatch final : public sf::Drawable, private sf::NonCopyable
+{
+public:
+    explicit TextBatch(const sf::Font& font);
+    ~TextBatch() = default;
+
+    //returns an ID used to modify the text
+    sf::Uint32 addText(const std::string& string, sf::Uint32 charSize = 30u, bool bold = false);
+    void removeText(sf::Uint32 id);
+
+    //changing the string is the only thing which causes the text to be laid out
+    //again. position, origin, scale and colour are applied to cached geometry
+    void setString(sf::Uint32 id, const std::string& string);
+    void setPosition(sf::Uint32 id, const sf::Vector2f& position);
+    const sf::Vector2f& getPosition(sf::Uint32 id) const;
+    void move(sf::Uint32 id, const sf::Vector2f& amount);
+    void setOrigin(sf::Uint32 id, const sf::Vector2f& origin);
+    void setScale(sf::Uint32 id, float scale);
+    float getScale(sf::Uint32 id) const;
+    void setColour(sf::Uint32 id, const sf::Color& colour);
+    void setVisible(sf::Uint32 id, bool visible);
+
+    sf::FloatRect getLocalBounds(sf::Uint32 id) const;
+    sf::FloatRect getGlobalBounds(sf::Uint32 id) const;
+    //the origin is kept centred until setOrigin() is called. this doesn't
+    //touch the font, the origin is updated when the text is next laid out
+    void centreOrigin(sf::Uint32 id);
+
+    //copy of the visible strings and their properties. taking a snapshot never
+    //touches the font, so a batch owned by another thread can be copied and
+    //then laid out by applySnapshot() on the thread which owns the font
+    struct Snapshot final
+    {
+        struct Text final
+        {
+            std::string string;
+            sf::Uint32 charSize = 30u;
+            bool bold = false;
+            sf::Vector2f position;
+            sf::Vector2f origin;
+            bool centred = false;
+            float scale = 1.f;
+            sf::Color colour;
+        };
+        const sf::Font* font = nullptr;
+        std::vector<Text> texts; //storage is reused so only the first count are valid
+        std::size_t count = 0u;
+    };
+    void getSnapshot(Snapshot& snapshot) const;
+    //replaces the contents of this batch. only strings which changed are laid out again
+    void applySnapshot(const Snapshot& snapshot);
+
+private:
+    struct Text
+    {
+        Text();
+        std::string string;
+        sf::Uint32 charSize;
+        bool bold;
+        sf::Vector2f position;
+        sf::Vector2f origin;
+        bool centred;
+        float scale;
+        sf::Color colour;
+        bool visible;
+        bool active;
+
+        bool layoutDirty;
+        sf::FloatRect bounds;
+        std::vector<sf::Vertex> glyphs; //untransformed quads
+        std::vector<sf::Vertex> vertices; //transformed quads
+    };
+
+    const sf::Font& m_font;
+    mutable std::vector<Text> m_texts;
+    std::vector<sf::Uint32> m_freeIds;
+
+    //vertex arrays are rebuilt only when one of their texts changes
+    mutable std::map<sf::Uint32, sf::VertexArray> m_pages;
+    mutable std::map<sf::Uint32, bool> m_dirtyPages;
+
+    Text& getText(sf::Uint32 id);
+    const Text& getText(sf::Uint32 id) const;
+    void markDirty(Text& text, bool layout = false);
+    void layout(Text& text) const;
+    void transform(Text& text) const;
+    void updatePages() const;
+    void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
+};
+
+#endif //TEXT_BATCH_H_
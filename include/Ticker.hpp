@@ -30,6 +30,8 @@ source distribution.
 #ifndef TICKER_H_
 #define TICKER_H_
 
+#include <TextBatch.hpp>
+
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Font.hpp>
@@ -51,8 +53,8 @@ public:
     sf::Uint16 getMessageCount() const;
 
 private:
-    sf::Font& m_font;
-    std::vector<sf::Text> m_messages;
+    TextBatch m_textBatch;
+    std::vector<sf::Uint32> m_messages;
     sf::FloatRect m_size;
     float m_speed;
     float m_totalWidth;
@@ -37,45 +37,61 @@ source distribution.
 #include <SFML/System/NonCopyable.hpp>
 
 #include <vector>
+#include <list>
+#include <random>
 
+class JobSystem;
 class WaterDrawable final : public sf::Drawable, private sf::NonCopyable
 {
 public:
-    WaterDrawable(sf::Texture& normalMap, sf::Shader& shader, const sf::Vector2f& size = sf::Vector2f(20.f, 20.f));
+    WaterDrawable(const Resource::Handle<sf::Texture>& normalMap, sf::Shader& shader, const sf::Vector2f& size = sf::Vector2f(20.f, 20.f));
     ~WaterDrawable() = default;
 
     void splash(float position, float speed);
     void update(float dt);
+    //steps all the given water bodies as jobs, then rebuilds their vertices
+    static void update(std::list<WaterDrawable>& drawables, float dt, JobSystem& jobSystem);
 
     void setSize(const sf::Vector2f& size);
     void setColours(const sf::Color& lightColour, const sf::Color& darkColour);
 
-private:
-    struct Column
+    //copy of the water surface which can be drawn while the original is updated
+    struct Snapshot final : public sf::Drawable
     {
-        Column();
-        void update(float dt);
-
-        float targetHeight;
-        float height;
-        float speed;
+        sf::VertexArray vertices;
+        const sf::Texture* normalMap = nullptr;
+        sf::Shader* shader = nullptr;
+        float waveTime = 0.f;
+    private:
+        void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
     };
+    void getSnapshot(Snapshot& snapshot) const;
 
+private:
     sf::Vector2f m_size;
     sf::Color m_lightColour;
     sf::Color m_darkColour;
 
-    std::vector<Column> m_columns;
-    mutable sf::VertexArray m_vertices;
+    //column properties are kept in separate arrays so the
+    //solver loops are straight runs over contiguous floats
+    std::vector<float> m_heights;
+    std::vector<float> m_speeds;
+    std::vector<float> m_deltas; //scratch space for the spread pass
+    sf::VertexArray m_vertices;
 
-    sf::Texture m_normalTexture;
+    Resource::Handle<sf::Texture> m_normalTexture;
     float m_texHeight;
     sf::Shader* m_shader;
 
     sf::Uint8 m_waveIndex;
     float m_waveTime;
+    //each body has its own engine so they can be stepped in parallel
+    std::minstd_rand m_randomEngine;
 
     void resize();
+    void step(float dt);
+    //only rewrites the surface vertices of columns which have moved
+    void updateVertices();
     void draw(sf::RenderTarget& rt, sf::RenderStates states) const override;
 };
 
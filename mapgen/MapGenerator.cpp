@@ -0,0 +1,393 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include "MapGenerator.hpp"
+
+#include <picojson.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    const float wallThickness = 20.f;
+    const float platformHeight = 30.f;
+    const float rowSpacing = 180.f; //leaves room for a player or a couple of blocks under each row
+    const float minPlatformWidth = 40.f;
+    const float maxWaterWidth = 500.f;
+    const float waterHeight = 80.f;
+    const float spawnClearance = 100.f; //no blocks are stacked this close to the player spawns
+
+    const sf::Vector2f playerSize(40.f, 64.f);
+    const sf::Vector2f itemSize(64.f, 64.f);
+    const sf::Vector2f lightSize(32.f, 32.f);
+
+    //edging is laid along the top of each platform by the editor
+    const std::string edgingSheet = "edging.png";
+    const sf::Vector2f edgeTileSize(80.f, 22.f);
+    const sf::Vector2f edgeLeftSize(34.f, 22.f);
+    const sf::Vector2f edgeRightSize(28.f, 22.f);
+
+    struct Scenery final
+    {
+        const char* frame;
+        sf::Vector2f size;
+    };
+    const std::string scenerySheet = "scenery01.png";
+    const std::vector<Scenery> scenery =
+    {
+        { "Bush-01.png", { 107.f, 53.f } },
+        { "Bush-02.png", { 80.f, 53.f } },
+        { "Bush-03.png", { 80.f, 80.f } },
+        { "Fence-01.png", { 107.f, 53.f } },
+        { "Lantern-01.png", { 80.f, 133.f } },
+        { "Lantern-02.png", { 53.f, 107.f } },
+        { "Rock03.png", { 107.f, 80.f } },
+        { "Rock_Large-01.png", { 80.f, 80.f } },
+        { "Rock_Large-02.png", { 133.f, 80.f } },
+        { "Shroom-01.png", { 53.f, 27.f } },
+        { "Shroom-02.png", { 27.f, 53.f } },
+        { "Vine_Small-01.png", { 80.f, 80.f } }
+    };
+
+    //same values as the shipped maps
+    const std::vector<sf::Color> lightColours =
+    {
+        { 252u, 197u, 29u },
+        { 255u, 252u, 230u },
+        { 249u, 215u, 79u }
+    };
+    const sf::Color ambientColour(27u, 27u, 27u);
+    const sf::Color sunColour(75u, 100u, 214u);
+    const sf::Uint32 maxNpcs = 255u; //stored as Uint8 by Map
+
+    //must match the strings parsed by Map::Node
+    std::string typeString(Category::Type type)
+    {
+        switch (type)
+        {
+        case Category::Block: return "Block";
+        case Category::Solid: return "Solid";
+        case Category::PlayerOne: return "PlayerOne";
+        case Category::PlayerTwo: return "PlayerTwo";
+        case Category::Item: return "Item";
+        case Category::Water: return "Water";
+        case Category::Light: return "Light";
+        case Category::Detail: return "Detail";
+        default:
+            assert(false);
+            return "";
+        }
+    }
+
+    std::string layerString(Scene::Layer layer)
+    {
+        switch (layer)
+        {
+        case Scene::FrontDetail: return "FrontDetail";
+        case Scene::Solid: return "Solid";
+        case Scene::Water: return "Water";
+        case Scene::DynamicRear: return "Dynamic";
+        case Scene::RearDetail: return "RearDetail";
+        default:
+            assert(false);
+            return "";
+        }
+    }
+
+    std::string vecString(const sf::Vector2f& v)
+    {
+        return std::to_string(static_cast<int>(std::round(v.x))) + ", " + std::to_string(static_cast<int>(std::round(v.y)));
+    }
+
+    //inverse of the conversion in Map.cpp
+    double colourToDouble(const sf::Color& c)
+    {
+        const sf::Uint32 value = (static_cast<sf::Uint32>(c.a) << 24) | (c.r << 16) | (c.g << 8) | c.b;
+        return static_cast<double>(static_cast<sf::Int32>(value));
+    }
+
+    Map::Node makeNode(Category::Type type, Scene::Layer layer, const sf::Vector2f& position, const sf::Vector2f& size)
+    {
+        Map::Node n;
+        n.type = type;
+        n.layer = layer;
+        n.position = position;
+        n.size = size;
+        n.colour = sf::Color::Transparent;
+        return n;
+    }
+
+    //somewhere blocks, items and scenery can be placed
+    struct Surface final
+    {
+        float left = 0.f;
+        float right = 0.f;
+        float top = 0.f;
+        float headroom = 0.f;
+        sf::Uint32 blockCount = 0u;
+    };
+}
+
+using namespace MapGen;
+
+Generator::Generator(const Settings& settings)
+    : m_settings(settings)
+{
+    if (m_settings.npcTotal > maxNpcs)
+    {
+        std::cerr << "MapGen: NPC total clamped to " << maxNpcs << std::endl;
+        m_settings.npcTotal = maxNpcs;
+    }
+    m_settings.npcCount = std::min(m_settings.npcCount, m_settings.npcTotal);
+
+    //seeded so the same settings always make the same map
+    std::mt19937 rndEngine(m_settings.seed);
+    auto random = [&rndEngine](float begin, float end)
+    {
+        if (end <= begin) return begin;
+        std::uniform_real_distribution<float> dist(begin, end);
+        return dist(rndEngine);
+    };
+    auto randomIndex = [&rndEngine](std::size_t size)
+    {
+        std::uniform_int_distribution<std::size_t> dist(0u, size - 1u);
+        return dist(rndEngine);
+    };
+
+    const auto& world = m_settings.worldSize;
+    const float floorTop = world.y - wallThickness;
+    const float innerWidth = world.x - (wallThickness * 2.f);
+
+    //walls and floor
+    m_nodes.push_back(makeNode(Category::Solid, Scene::Solid, { 0.f, 0.f }, { wallThickness, floorTop }));
+    m_nodes.push_back(makeNode(Category::Solid, Scene::Solid, { world.x - wallThickness, 0.f }, { wallThickness, floorTop }));
+    m_nodes.push_back(makeNode(Category::Solid, Scene::Solid, { 0.f, floorTop }, { world.x, wallThickness }));
+
+    //platforms are laid out in rows, with each row split into equal slots
+    const float firstRow = rowSpacing;
+    const sf::Uint32 rowCount = std::max(1, static_cast<int>((floorTop - platformHeight - firstRow - rowSpacing) / rowSpacing) + 1);
+    std::vector<Surface> surfaces;
+    float lowestPlatform = 0.f;
+    for (auto i = 0u; i < m_settings.platforms; ++i)
+    {
+        const sf::Uint32 row = i % rowCount;
+        const sf::Uint32 slot = i / rowCount;
+        const sf::Uint32 slotCount = (m_settings.platforms - row + rowCount - 1u) / rowCount;
+        const float slotWidth = innerWidth / slotCount;
+
+        const float width = std::max(slotWidth * random(0.5f, 0.85f), std::min(minPlatformWidth, slotWidth));
+        const sf::Vector2f position(wallThickness + (slot * slotWidth) + random(0.f, slotWidth - width), firstRow + (row * rowSpacing));
+        m_nodes.push_back(makeNode(Category::Solid, Scene::Solid, position, { width, platformHeight }));
+        lowestPlatform = std::max(lowestPlatform, position.y + platformHeight);
+
+        Surface surface;
+        surface.left = position.x;
+        surface.right = position.x + width;
+        surface.top = position.y;
+        surface.headroom = rowSpacing - platformHeight;
+        surfaces.push_back(surface);
+
+        //edging, offset the same way the editor places it
+        if (width < edgeLeftSize.x + edgeRightSize.x) continue;
+
+        const float edgeY = position.y - 10.f;
+        auto edge = makeNode(Category::Detail, Scene::FrontDetail, { position.x - 10.f, edgeY }, edgeLeftSize);
+        edge.spriteSheet = edgingSheet;
+        edge.image = "edge_end_left.png";
+        m_nodes.push_back(edge);
+
+        const float edgeRight = position.x + width - 20.f;
+        for (auto x = position.x + 20.f; x + edgeTileSize.x <= edgeRight; x += edgeTileSize.x)
+        {
+            edge = makeNode(Category::Detail, Scene::FrontDetail, { x, edgeY }, edgeTileSize);
+            edge.spriteSheet = edgingSheet;
+            edge.image = "edge_tile.png";
+            m_nodes.push_back(edge);
+        }
+
+        edge = makeNode(Category::Detail, Scene::FrontDetail, { edgeRight, edgeY }, edgeRightSize);
+        edge.spriteSheet = edgingSheet;
+        edge.image = "edge_end_right.png";
+        m_nodes.push_back(edge);
+    }
+
+    //the floor is a surface too, minus the space around the spawn points
+    Surface floor;
+    floor.left = wallThickness + spawnClearance;
+    floor.right = world.x - wallThickness - spawnClearance;
+    floor.top = floorTop;
+    floor.headroom = floorTop - std::max(lowestPlatform, rowSpacing);
+    surfaces.push_back(floor);
+
+    //water sits on the floor, spread evenly along it
+    for (auto i = 0u; i < m_settings.waterBodies; ++i)
+    {
+        const float slotWidth = innerWidth / m_settings.waterBodies;
+        const float width = std::min(maxWaterWidth, slotWidth * random(0.5f, 0.8f));
+        const sf::Vector2f position(wallThickness + (i * slotWidth) + random(0.f, slotWidth - width), floorTop - waterHeight);
+        m_nodes.push_back(makeNode(Category::Water, Scene::Water, position, { width, waterHeight }));
+    }
+
+    m_playerOneSpawn = { wallThickness + 20.f, floorTop - playerSize.y - 10.f };
+    m_playerTwoSpawn = { world.x - wallThickness - 20.f - playerSize.x, m_playerOneSpawn.y };
+    m_nodes.push_back(makeNode(Category::PlayerOne, Scene::DynamicRear, m_playerOneSpawn, playerSize));
+    m_nodes.push_back(makeNode(Category::PlayerTwo, Scene::DynamicRear, m_playerTwoSpawn, playerSize));
+
+    //blocks are stacked in a grid on each surface in turn. once a surface
+    //is full further blocks overlap and are pushed apart by the physics
+    const sf::Uint32 blockCount = static_cast<sf::Uint32>(std::round(m_settings.blockDensity * surfaces.size()));
+    const float pitch = m_settings.blockSize + 4.f;
+    sf::Uint32 overlapCount = 0u;
+    for (auto i = 0u; i < blockCount; ++i)
+    {
+        auto& surface = surfaces[i % surfaces.size()];
+        const sf::Uint32 columns = std::max(1, static_cast<int>((surface.right - surface.left) / pitch));
+        const sf::Uint32 levels = std::max(1, static_cast<int>(surface.headroom / pitch));
+        sf::Uint32 slot = surface.blockCount++;
+        if (slot >= columns * levels)
+        {
+            overlapCount++;
+            slot %= columns * levels;
+        }
+
+        const sf::Vector2f position(surface.left + ((slot % columns) * pitch) + 2.f, surface.top - (((slot / columns) + 1) * pitch));
+        m_nodes.push_back(makeNode(Category::Block, Scene::DynamicRear, position, { m_settings.blockSize, m_settings.blockSize }));
+    }
+    if (overlapCount > 0)
+    {
+        std::cerr << "MapGen: " << overlapCount << " blocks overlap, use a larger world or smaller blocks to avoid this" << std::endl;
+    }
+
+    //items float above platforms
+    for (auto i = 0u; i < m_settings.items; ++i)
+    {
+        const auto& surface = surfaces[randomIndex(surfaces.size())];
+        const sf::Vector2f position(random(surface.left, surface.right - itemSize.x), surface.top - itemSize.y - 16.f);
+        m_nodes.push_back(makeNode(Category::Item, Scene::DynamicRear, position, itemSize));
+    }
+
+    for (auto i = 0u; i < m_settings.lights; ++i)
+    {
+        const sf::Vector2f position(random(wallThickness, world.x - wallThickness - lightSize.x), random(40.f, floorTop - 200.f));
+        auto light = makeNode(Category::Light, Scene::FrontDetail, position, lightSize);
+        light.colour = lightColours[randomIndex(lightColours.size())];
+        m_nodes.push_back(light);
+    }
+
+    //scenery stands on top of the platforms, behind everything else
+    for (auto i = 0u; i < m_settings.details; ++i)
+    {
+        const auto& surface = surfaces[randomIndex(surfaces.size())];
+        const auto& sprite = scenery[randomIndex(scenery.size())];
+        const sf::Vector2f position(random(surface.left, surface.right - sprite.size.x), surface.top - sprite.size.y);
+        auto detail = makeNode(Category::Detail, Scene::RearDetail, position, sprite.size);
+        detail.spriteSheet = scenerySheet;
+        detail.image = sprite.frame;
+        m_nodes.push_back(detail);
+    }
+}
+
+//public
+const std::vector<Map::Node>& Generator::getNodes() const
+{
+    return m_nodes;
+}
+
+bool Generator::write(const std::string& path) const
+{
+    picojson::array nodes;
+    for (const auto& n : m_nodes)
+    {
+        picojson::object node;
+        node["Position"] = picojson::value(vecString(n.position));
+        node["Size"] = picojson::value(vecString(n.size));
+        node["Type"] = picojson::value(typeString(n.type));
+        node["Layer"] = picojson::value(layerString(n.layer));
+        node["Colour"] = picojson::value(colourToDouble(n.colour));
+        if (!n.spriteSheet.empty())
+        {
+            node["SpriteSheet"] = picojson::value(n.spriteSheet);
+            node["FrameName"] = picojson::value(n.image);
+        }
+        node["AnchorOffset"] = picojson::value(static_cast<double>(n.anchorOffset));
+        nodes.push_back(picojson::value(node));
+    }
+
+    picojson::object map;
+    map["NpcCount"] = picojson::value(static_cast<double>(m_settings.npcCount));
+    map["NpcTotal"] = picojson::value(static_cast<double>(m_settings.npcTotal));
+    map["BackgroundTexture"] = picojson::value(std::string("background.png"));
+    map["PlatformTexture"] = picojson::value(std::string("brick.png"));
+    map["MapName"] = picojson::value(m_settings.name);
+    map["PlayerOneSpawn"] = picojson::value(vecString(m_playerOneSpawn));
+    map["PlayerTwoSpawn"] = picojson::value(vecString(m_playerTwoSpawn));
+    map["AmbientColour"] = picojson::value(colourToDouble(ambientColour));
+    map["SunColour"] = picojson::value(colourToDouble(sunColour));
+    map["AudioTheme"] = picojson::value(std::string("night"));
+    map["Nodes"] = picojson::value(nodes);
+
+    std::ofstream file(path);
+    if (!file.good())
+    {
+        std::cerr << "MapGen: failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+    file << picojson::value(map).serialize(true);
+    file.close();
+
+    //make sure the game reads back what was written
+    Map loaded(path);
+    const auto& loadedNodes = loaded.getNodes();
+    if (loadedNodes.size() != m_nodes.size())
+    {
+        std::cerr << "MapGen: wrote " << m_nodes.size() << " nodes but " << loadedNodes.size() << " were loaded" << std::endl;
+        return false;
+    }
+
+    for (auto i = 0u; i < m_nodes.size(); ++i)
+    {
+        if (loadedNodes[i].type != m_nodes[i].type
+            || loadedNodes[i].layer != m_nodes[i].layer)
+        {
+            std::cerr << "MapGen: node " << i << " (" << typeString(m_nodes[i].type) << ") was not loaded as written" << std::endl;
+            return false;
+        }
+    }
+
+    if (loaded.getNpcTotal() != m_settings.npcTotal)
+    {
+        std::cerr << "MapGen: NPC total was not loaded as written" << std::endl;
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
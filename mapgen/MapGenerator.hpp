@@ -0,0 +1,83 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//generates stress test maps in the same .crm format written by the level
+//editor, with node counts well beyond what fits in the shipped maps
+
+#ifndef MAP_GENERATOR_H_
+#define MAP_GENERATOR_H_
+
+#include <Map.hpp>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+
+namespace MapGen
+{
+    struct Settings final
+    {
+        std::string name = "stress.crm";
+        sf::Uint32 seed = 1u;
+        sf::Vector2f worldSize = { 1920.f, 1080.f };
+
+        sf::Uint32 platforms = 12u;
+        float blockDensity = 1.2f; //blocks per platform, the floor counts as one
+        float blockSize = 66.f;
+        sf::Uint32 waterBodies = 2u;
+        sf::Uint32 lights = 4u;
+        sf::Uint32 details = 30u; //rear scenery, platform edging is added regardless
+        sf::Uint32 items = 3u;
+        sf::Uint32 npcCount = 3u; //on screen at once
+        sf::Uint32 npcTotal = 12u;
+    };
+
+    class Generator final
+    {
+    public:
+        explicit Generator(const Settings& settings);
+        ~Generator() = default;
+        Generator(const Generator&) = delete;
+        Generator& operator = (const Generator&) = delete;
+
+        const std::vector<Map::Node>& getNodes() const;
+
+        //writes the map then loads it back with the game's parser to
+        //make sure every node survived. returns false on failure
+        bool write(const std::string& path) const;
+
+    private:
+        Settings m_settings;
+        sf::Vector2f m_playerOneSpawn;
+        sf::Vector2f m_playerTwoSpawn;
+        std::vector<Map::Node> m_nodes;
+    };
+}
+
+#endif //MAP_GENERATOR_H_
\ No newline at end of file
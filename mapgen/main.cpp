@@ -0,0 +1,137 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//writes procedurally generated maps for stress testing, eg with thousands of blocks or hundreds of lights
+//crush_mapgen <file.crm> [--seed <n>] [--size <w,h>] [--platforms <n>] [--block-density <n>]
+//  [--block-size <n>] [--water <n>] [--lights <n>] [--details <n>] [--items <n>]
+//  [--npcs <total>] [--npc-count <n>]
+
+#include "MapGenerator.hpp"
+
+#include <Util.hpp>
+
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace
+{
+    const std::string usage =
+        "usage: crush_mapgen <file.crm> [--seed <n>] [--size <w,h>] [--platforms <n>] [--block-density <n>]\n"
+        "    [--block-size <n>] [--water <n>] [--lights <n>] [--details <n>] [--items <n>]\n"
+        "    [--npcs <total>] [--npc-count <n>]";
+
+    bool parseValue(const std::string& str, float& value)
+    {
+        try
+        {
+            value = std::stof(str);
+        }
+        catch (...)
+        {
+            std::cerr << "invalid value: " << str << std::endl;
+            return false;
+        }
+        return value >= 0.f;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    MapGen::Settings settings;
+    const std::string path = argv[1];
+    settings.name = path.substr(path.find_last_of("/\\") + 1);
+
+    std::map<std::string, sf::Uint32*> counts =
+    {
+        { "--seed", &settings.seed },
+        { "--platforms", &settings.platforms },
+        { "--water", &settings.waterBodies },
+        { "--lights", &settings.lights },
+        { "--details", &settings.details },
+        { "--items", &settings.items },
+        { "--npcs", &settings.npcTotal },
+        { "--npc-count", &settings.npcCount }
+    };
+
+    for (auto i = 2; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+
+        const std::string str = argv[++i];
+        float value = 0.f;
+        auto result = counts.find(arg);
+        if (arg == "--size")
+        {
+            settings.worldSize = Util::Vector::vec2FromString<float>(str);
+            if (settings.worldSize.x <= 0.f || settings.worldSize.y <= 0.f)
+            {
+                std::cerr << "world size should be given as <width,height>" << std::endl;
+                return 1;
+            }
+        }
+        else if (!parseValue(str, value))
+        {
+            return 1;
+        }
+        else if (result != counts.end())
+        {
+            *result->second = static_cast<sf::Uint32>(value);
+        }
+        else if (arg == "--block-density")
+        {
+            settings.blockDensity = value;
+        }
+        else if (arg == "--block-size" && value > 0.f)
+        {
+            settings.blockSize = value;
+        }
+        else
+        {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    MapGen::Generator generator(settings);
+    if (!generator.write(path))
+        return 1;
+
+    std::cout << "wrote " << generator.getNodes().size() << " nodes to " << path << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -29,6 +29,11 @@ source distribution.
 #include <Particles.hpp>
 #include <Util.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AFFECTORS_SSE2
+#include <emmintrin.h>
+#endif //SSE2
+
 namespace
 {
     sf::Uint8 lerp(sf::Uint8 start, sf::Uint8 end, float amount)
@@ -36,6 +41,23 @@ namespace
         float val = static_cast<float>(end - start) * amount;
         return start + static_cast<sf::Uint8>(val);
     }
+
+    //adds amount to every value, four at a time where SSE2 is available
+    void addToAll(float* values, float amount, std::size_t count)
+    {
+        std::size_t i = 0u;
+#ifdef AFFECTORS_SSE2
+        const __m128 add = _mm_set1_ps(amount);
+        for (; i + 4u <= count; i += 4u)
+        {
+            _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), add));
+        }
+#endif //AFFECTORS_SSE2
+        for (; i < count; ++i)
+        {
+            values[i] += amount;
+        }
+    }
 }
 
 //------------------------------------
@@ -43,15 +65,31 @@ ForceAffector::ForceAffector(const sf::Vector2f& force)
     : m_force   (force),
     m_random    (false){}
 
-void ForceAffector::operator() (Particle& p, float dt)
+void ForceAffector::operator() (ParticleData& data, std::size_t i, float dt)
 {
     if (m_random)
     {
-        m_force.x = Util::Random::value(m_randomStart.x, m_randomEnd.x);
-        m_force.y = Util::Random::value(m_randomStart.y, m_randomEnd.y);
+        m_force.x = std::uniform_real_distribution<float>(m_randomStart.x, m_randomEnd.x)(m_randomEngine);
+        m_force.y = std::uniform_real_distribution<float>(m_randomStart.y, m_randomEnd.y)(m_randomEngine);
     }
 
-    p.velocity += m_force * dt;
+    data.velocityX[i] += m_force.x * dt;
+    data.velocityY[i] += m_force.y * dt;
+}
+
+void ForceAffector::apply(ParticleData& data, float dt)
+{
+    if (m_random)
+    {
+        //each particle gets its own force so can't be vectorised
+        for (auto i = 0u; i < data.count; ++i)
+            (*this)(data, i, dt);
+    }
+    else
+    {
+        addToAll(data.velocityX.data(), m_force.x * dt, data.count);
+        addToAll(data.velocityY.data(), m_force.y * dt, data.count);
+    }
 }
 
 void ForceAffector::setRandom(const sf::Vector2f& rangeStart, const sf::Vector2f& rangeEnd)
@@ -61,37 +99,57 @@ void ForceAffector::setRandom(const sf::Vector2f& rangeStart, const sf::Vector2f
     m_randomStart = rangeStart;
     m_randomEnd = rangeEnd;
     m_random = true;
+    m_randomEngine.seed(Util::Random::value(0, 0xffff));
 }
 
 //------------------------------------
 ColourAffector::ColourAffector(const sf::Color& start, const sf::Color& end, float duration)
     : m_duration(duration), m_start(start), m_end(end){}
 
-void ColourAffector::operator() (Particle& p, float dt)
+void ColourAffector::operator() (ParticleData& data, std::size_t i, float)
 {
-    float ratio = (m_duration - p.lifetime) / m_duration;
+    float ratio = (m_duration - data.lifetime[i]) / m_duration;
     if (ratio > 1.f) ratio = 1.f;
     if (ratio < 0.f) ratio = 0.f;
 
-    p.colour.r = lerp(m_start.r, m_end.r, ratio);
-    p.colour.g = lerp(m_start.g, m_end.g, ratio);
-    p.colour.b = lerp(m_start.b, m_end.b, ratio);
+    auto& colour = data.colour[i];
+    colour.r = lerp(m_start.r, m_end.r, ratio);
+    colour.g = lerp(m_start.g, m_end.g, ratio);
+    colour.b = lerp(m_start.b, m_end.b, ratio);
+}
+
+void ColourAffector::apply(ParticleData& data, float dt)
+{
+    for (auto i = 0u; i < data.count; ++i)
+        (*this)(data, i, dt);
 }
 
 //------------------------------------
 RotateAffector::RotateAffector(float rotation)
     : m_rotation(rotation){}
 
-void RotateAffector::operator() (Particle& p, float dt)
+void RotateAffector::operator() (ParticleData& data, std::size_t i, float dt)
 {
-    p.rotate(m_rotation * dt);
+    data.rotation[i] += m_rotation * dt;
+}
+
+void RotateAffector::apply(ParticleData& data, float dt)
+{
+    addToAll(data.rotation.data(), m_rotation * dt, data.count);
 }
 
 //------------------------------------
 ScaleAffector::ScaleAffector(const sf::Vector2f& scale)
     : m_scale(scale){}
 
-void ScaleAffector::operator()(Particle& p, float dt)
+void ScaleAffector::operator()(ParticleData& data, std::size_t i, float dt)
 {
-    p.setScale(p.getScale() + (m_scale *  dt));
-}
\ No newline at end of file
+    data.scaleX[i] += m_scale.x * dt;
+    data.scaleY[i] += m_scale.y * dt;
+}
+
+void ScaleAffector::apply(ParticleData& data, float dt)
+{
+    addToAll(data.scaleX.data(), m_scale.x * dt, data.count);
+    addToAll(data.scaleY.data(), m_scale.y * dt, data.count);
+}
@@ -0,0 +1,112 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//throw() rather than noexcept as VS2013 doesn't support the latter
+
+#include <AllocationHook.hpp>
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+    std::atomic<AllocationHook::Callback> callback(nullptr);
+}
+
+void AllocationHook::setCallback(Callback cb)
+{
+    callback = cb;
+}
+
+void* operator new(std::size_t size)
+{
+    if (auto cb = callback.load(std::memory_order_relaxed)) cb(size);
+    if (size == 0) size = 1;
+
+    while (true)
+    {
+        void* ptr = std::malloc(size);
+        if (ptr) return ptr;
+
+        auto handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    try
+    {
+        return operator new(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) throw()
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) throw()
+{
+    std::free(ptr);
+}
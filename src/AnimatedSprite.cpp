@@ -28,16 +28,30 @@ source distribution.
 #include <AnimatedSprite.hpp>
 #include <Resource.hpp>
 #include <Util.hpp>
-#include <JsonUtil.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Shader.hpp>
-
-#include <picojson.h>
+#include <SFML/Graphics/Image.hpp>
 
 #include <cassert>
-#include <fstream>
+
+namespace
+{
+    //flat normal bound for sprites without a normal map, so they don't
+    //pick up whichever map the previous draw left on the shared shader
+    const sf::Texture& flatNormalMap()
+    {
+        static sf::Texture texture;
+        if (texture.getSize().x == 0u)
+        {
+            sf::Image i;
+            i.create(1u, 1u, sf::Color(127u, 127u, 255u));
+            texture.loadFromImage(i);
+        }
+        return texture;
+    }
+}
 
 AnimatedSprite::AnimatedSprite()
     : m_shader      (nullptr),
@@ -48,7 +62,8 @@ AnimatedSprite::AnimatedSprite()
     m_frameRate     (0.f),
     m_elapsedTime   (0.f),
     m_loop          (false),
-    m_playing       (false){}
+    m_playing       (false),
+    m_clipSet       (nullptr){}
 
 AnimatedSprite::AnimatedSprite(const sf::Texture& t)
     : m_sprite      (t),
@@ -61,7 +76,8 @@ AnimatedSprite::AnimatedSprite(const sf::Texture& t)
     m_frameRate     (0.f),
     m_elapsedTime   (0.f),
     m_loop          (false),
-    m_playing       (false){}
+    m_playing       (false),
+    m_clipSet       (nullptr){}
 
 AnimatedSprite::AnimatedSprite(const std::string& propertiesPath, TextureResource& tr)
     : m_shader      (nullptr),
@@ -72,74 +88,18 @@ AnimatedSprite::AnimatedSprite(const std::string& propertiesPath, TextureResourc
     m_frameRate     (0.f),
     m_elapsedTime   (0.f),
     m_loop          (false),
-    m_playing       (false)
+    m_playing       (false),
+    m_clipSet       (&AnimationLibrary::get(propertiesPath))
 {
-    std::ifstream file(propertiesPath);
-    assert(file.good());
-    assert(Util::File::validLength(file));
-
-    std::string jsonString;
-    while (!file.eof())
-    {
-        std::string temp;
-        file >> temp;
-        jsonString += temp;
-    }
-    assert(!jsonString.empty());
-    file.close();
+    m_frameCount = m_clipSet->frameCount;
+    m_frameRate = m_clipSet->frameRate;
+    setFrameSize(m_clipSet->frameSize);
 
-    picojson::value pv;
-    auto err = picojson::parse(pv, jsonString);
-    if (err.empty())
-    {
-        //get array of animations
-        if (pv.get("Animations").is<picojson::array>())
-        {
-            const auto& anims = pv.get("Animations").get<picojson::array>();
-            for (const auto& a : anims)
-            {
-                std::string name = (a.get("Name").is<std::string>()) ? a.get("Name").get<std::string>() : "";
-                sf::Int16 start = (a.get("Start").is<double>()) ? static_cast<sf::Int16>(a.get("Start").get<double>()) : 0;
-                sf::Int16 end = (a.get("End").is<double>()) ? static_cast<sf::Int16>(a.get("End").get<double>()) : 0;
-                bool loop = (a.get("Loop").is<bool>()) ? a.get("Loop").get<bool>() : false;
-                m_animations.emplace_back(name, start, end, loop);
-            }
-        }
-
-        //properties
-        if (pv.get("FrameCount").is<double>())
-            m_frameCount = static_cast<sf::Uint8>(pv.get("FrameCount").get<double>());
-        else
-            std::cerr << propertiesPath << " missing frame count" << std::endl;
-
-        if (pv.get("FrameSize").is<std::string>())
-            setFrameSize(Util::Vector::vec2FromString<int>(pv.get("FrameSize").get<std::string>()));
-        else
-            std::cerr << propertiesPath << " missing frame size" << std::endl;
-
-        if (pv.get("FrameRate").is<double>())
-            m_frameRate = static_cast<float>(pv.get("FrameRate").get<double>());
-        else
-            std::cerr << propertiesPath << " missing frame rate" << std::endl;
-
-        std::string filePath;
-        auto result = propertiesPath.find_last_of('/');
-        if (result != std::string::npos)
-            filePath = propertiesPath.substr(0, result + 1);
-
-        if (pv.get("Texture").is<std::string>())
-            setTexture(tr.get(filePath + pv.get("Texture").get<std::string>()));
-        else
-            std::cerr << propertiesPath << " missing texture name" << std::endl;
-
-        if (pv.get("NormalMap").is<std::string>())
-            setNormalMap(tr.get(filePath + pv.get("NormalMap").get<std::string>()));
-    }
-    else
-    {
-        std::cerr << "Animated Sprite: " << err << std::endl;
-    }
+    if (!m_clipSet->texturePath.empty())
+        setTexture(tr.getHandle(m_clipSet->texturePath));
 
+    if (!m_clipSet->normalMapPath.empty())
+        setNormalMap(tr.getHandle(m_clipSet->normalMapPath));
 }
 
 //public
@@ -186,12 +146,18 @@ void AnimatedSprite::setTexture(const sf::Texture& t)
     m_textureSize = t.getSize();
 }
 
+void AnimatedSprite::setTexture(const Resource::Handle<sf::Texture>& t)
+{
+    m_texture = t;
+    setTexture(*t);
+}
+
 const sf::Texture* AnimatedSprite::getTexture() const
 {
     return m_sprite.getTexture();
 }
 
-void AnimatedSprite::setNormalMap(const sf::Texture& t)
+void AnimatedSprite::setNormalMap(const Resource::Handle<sf::Texture>& t)
 {
     m_normalMap = t;
 }
@@ -252,12 +218,25 @@ void AnimatedSprite::play(sf::Int16 start, sf::Int16 end)
     setFrame(start);
 }
 
-void AnimatedSprite::play(Animation animation)
+void AnimatedSprite::play(const Animation& animation)
 {
     setLooped(animation.m_loop);
     play(animation.m_startFrame, animation.m_endFrame);
 }
 
+void AnimatedSprite::playClip(sf::Int16 clipId)
+{
+    assert(m_clipSet && clipId >= 0 && clipId < static_cast<sf::Int16>(m_clipSet->clips.size()));
+    play(m_clipSet->clips[clipId]);
+}
+
+void AnimatedSprite::playClip(const std::string& clipName)
+{
+    assert(m_clipSet);
+    auto id = m_clipSet->getClipId(clipName);
+    if (id >= 0) play(m_clipSet->clips[id]);
+}
+
 bool AnimatedSprite::playing() const
 {
     return m_playing;
@@ -285,7 +264,20 @@ sf::FloatRect AnimatedSprite::getGlobalBounds() const
 
 const std::vector<Animation>& AnimatedSprite::getAnimations()const
 {
-    return m_animations;
+    static const std::vector<Animation> noAnimations;
+    return (m_clipSet) ? m_clipSet->clips : noAnimations;
+}
+
+const Animation* AnimatedSprite::getAnimation(const std::string& name) const
+{
+    if (!m_clipSet) return nullptr;
+    auto id = m_clipSet->getClipId(name);
+    return (id < 0) ? nullptr : &m_clipSet->clips[id];
+}
+
+sf::Int16 AnimatedSprite::getClipId(const std::string& name) const
+{
+    return (m_clipSet) ? m_clipSet->getClipId(name) : -1;
 }
 
 //private
@@ -293,7 +285,7 @@ void AnimatedSprite::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {    
     if (m_shader)
     {
-        m_shader->setParameter("u_normalMap", m_normalMap);
+        m_shader->setParameter("u_normalMap", (m_normalMap) ? *m_normalMap : flatNormalMap());
         m_shader->setParameter("u_diffuseMap", *m_sprite.getTexture());
         m_shader->setParameter("u_xNormMultiplier", getScale().x);
     }
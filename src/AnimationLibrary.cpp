@@ -0,0 +1,136 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <AnimationLibrary.hpp>
+#include <Util.hpp>
+#include <JsonUtil.hpp>
+
+#include <picojson.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <iostream>
+#include <cassert>
+
+namespace
+{
+    std::map<std::string, std::unique_ptr<AnimationClipSet>> clipSets;
+    std::mutex mutex;
+}
+
+void AnimationLibrary::parse(const std::string& path, AnimationClipSet& clipSet)
+{
+    std::ifstream file(path);
+    assert(file.good());
+    assert(Util::File::validLength(file));
+
+    std::string jsonString;
+    while (!file.eof())
+    {
+        std::string temp;
+        file >> temp;
+        jsonString += temp;
+    }
+    assert(!jsonString.empty());
+    file.close();
+
+    picojson::value pv;
+    auto err = picojson::parse(pv, jsonString);
+    if (!err.empty())
+    {
+        std::cerr << "Animation Library: " << err << std::endl;
+        return;
+    }
+
+    //get array of animations
+    if (pv.get("Animations").is<picojson::array>())
+    {
+        const auto& anims = pv.get("Animations").get<picojson::array>();
+        for (const auto& a : anims)
+        {
+            std::string name = (a.get("Name").is<std::string>()) ? a.get("Name").get<std::string>() : "";
+            sf::Int16 start = (a.get("Start").is<double>()) ? static_cast<sf::Int16>(a.get("Start").get<double>()) : 0;
+            sf::Int16 end = (a.get("End").is<double>()) ? static_cast<sf::Int16>(a.get("End").get<double>()) : 0;
+            bool loop = (a.get("Loop").is<bool>()) ? a.get("Loop").get<bool>() : false;
+
+            clipSet.clipIds.insert(std::make_pair(name, static_cast<sf::Int16>(clipSet.clips.size())));
+            clipSet.clips.emplace_back(name, start, end, loop);
+        }
+    }
+
+    //properties
+    if (pv.get("FrameCount").is<double>())
+        clipSet.frameCount = static_cast<sf::Uint8>(pv.get("FrameCount").get<double>());
+    else
+        std::cerr << path << " missing frame count" << std::endl;
+
+    if (pv.get("FrameSize").is<std::string>())
+        clipSet.frameSize = Util::Vector::vec2FromString<int>(pv.get("FrameSize").get<std::string>());
+    else
+        std::cerr << path << " missing frame size" << std::endl;
+
+    if (pv.get("FrameRate").is<double>())
+        clipSet.frameRate = static_cast<float>(pv.get("FrameRate").get<double>());
+    else
+        std::cerr << path << " missing frame rate" << std::endl;
+
+    std::string filePath;
+    auto result = path.find_last_of('/');
+    if (result != std::string::npos)
+        filePath = path.substr(0, result + 1);
+
+    if (pv.get("Texture").is<std::string>())
+        clipSet.texturePath = filePath + pv.get("Texture").get<std::string>();
+    else
+        std::cerr << path << " missing texture name" << std::endl;
+
+    if (pv.get("NormalMap").is<std::string>())
+        clipSet.normalMapPath = filePath + pv.get("NormalMap").get<std::string>();
+}
+
+sf::Int16 AnimationClipSet::getClipId(const std::string& name) const
+{
+    auto result = clipIds.find(name);
+    return (result == clipIds.end()) ? -1 : result->second;
+}
+
+const AnimationClipSet& AnimationLibrary::get(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto result = clipSets.find(path);
+    if (result != clipSets.end())
+        return *result->second;
+
+    auto clipSet = std::make_unique<AnimationClipSet>();
+    parse(path, *clipSet);
+    auto& retVal = *clipSet;
+    clipSets.insert(std::make_pair(path, std::move(clipSet)));
+    return retVal;
+}
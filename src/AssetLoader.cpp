@@ -0,0 +1,139 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <AssetLoader.hpp>
+#include <Resource.hpp>
+#include <JobSystem.hpp>
+#include <Profiler.hpp>
+
+#include <SFML/Graphics/Texture.hpp>
+
+#include <iostream>
+
+AssetLoader::AssetLoader(const Manifest& manifest, TextureResource& tr, JobSystem& jobSystem, std::function<void(float)> progress)
+    : m_decodedCount(0u)
+{
+    std::size_t textureCount = 0u;
+    for (const auto& t : manifest.textures)
+    {
+        //anything already cached may be referenced so is left alone
+        if (!tr.contains(t))
+        {
+            m_jobs.emplace_back(t, true);
+            textureCount++;
+        }
+    }
+    for (const auto& s : manifest.sounds)
+    {
+        m_jobs.emplace_back(s, false);
+        //buffers are created here so only the decoding happens on the workers
+        m_jobs.back().sound = std::make_unique<sf::SoundBuffer>();
+    }
+    if (m_jobs.empty())
+    {
+        if (progress) progress(1.f);
+        return;
+    }
+
+    JobSystem::Counter counter;
+    for (auto i = 0u; i < m_jobs.size(); ++i)
+        jobSystem.run([this, i](){ decode(i); }, counter);
+
+    //upload whatever has been decoded since the last batch
+    const float stepCount = static_cast<float>(m_jobs.size() + textureCount);
+    std::size_t uploadCount = 0u;
+    std::vector<std::size_t> batch;
+    while (uploadCount < textureCount)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this](){ return !m_decodedTextures.empty(); });
+            batch.swap(m_decodedTextures);
+        }
+
+        PROFILE_SCOPE("AssetLoader::upload");
+        for (auto i : batch)
+        {
+            auto& job = m_jobs[i];
+            if (job.loaded)
+            {
+                auto texture = std::make_shared<sf::Texture>();
+                if (texture->loadFromImage(job.image))
+                    tr.insert(job.path, Resource::Handle<sf::Texture>(texture));
+            }
+            job.image = sf::Image();
+        }
+        uploadCount += batch.size();
+        batch.clear();
+
+        if (progress) progress(static_cast<float>(m_decodedCount + uploadCount) / stepCount);
+    }
+
+    //helps decode any remaining sounds
+    jobSystem.wait(counter);
+
+    if (progress) progress(1.f);
+}
+
+//public
+std::unique_ptr<sf::SoundBuffer> AssetLoader::takeSound(const std::string& path)
+{
+    for (auto& j : m_jobs)
+    {
+        if (!j.texture && j.loaded && j.path == path)
+        {
+            return std::move(j.sound);
+        }
+    }
+    return nullptr;
+}
+
+//private
+void AssetLoader::decode(std::size_t index)
+{
+    PROFILE_TASK("AssetLoader::decode");
+
+    auto& job = m_jobs[index];
+    if (job.texture)
+    {
+        job.loaded = job.image.loadFromFile(job.path);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decodedTextures.push_back(index);
+        }
+        m_condition.notify_one();
+    }
+    else
+    {
+        job.loaded = job.sound->loadFromFile(job.path);
+    }
+
+    if (!job.loaded)
+        std::cerr << "Asset Loader: failed to load " << job.path << std::endl;
+
+    m_decodedCount++;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <AtlasPacker.hpp>
+
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+AtlasPacker::AtlasPacker(const sf::Vector2u& maxSize, sf::Uint32 padding)
+    : m_maxSize (maxSize),
+    m_padding   (padding)
+{
+    assert(maxSize.x > 0 && maxSize.y > 0);
+    clear();
+}
+
+//public
+bool AtlasPacker::insert(const sf::Vector2u& size, sf::Vector2u& position)
+{
+    const sf::Int32 width = static_cast<sf::Int32>(size.x) + m_padding;
+    const sf::Int32 height = static_cast<sf::Int32>(size.y) + m_padding;
+
+    sf::Int32 bestBottom = std::numeric_limits<sf::Int32>::max();
+    sf::Int32 bestWidth = std::numeric_limits<sf::Int32>::max();
+    sf::Int32 bestX = 0;
+    sf::Int32 bestY = 0;
+    std::size_t bestIndex = m_skyline.size();
+
+    //find the lowest position, preferring the narrowest level on a tie
+    for (auto i = 0u; i < m_skyline.size(); ++i)
+    {
+        sf::Int32 y = 0;
+        if (fits(i, width, height, y))
+        {
+            if (y + height < bestBottom
+                || (y + height == bestBottom && m_skyline[i].width < bestWidth))
+            {
+                bestBottom = y + height;
+                bestWidth = m_skyline[i].width;
+                bestX = m_skyline[i].x;
+                bestY = y;
+                bestIndex = i;
+            }
+        }
+    }
+
+    if (bestIndex == m_skyline.size()) return false;
+
+    addLevel(bestIndex, bestX, bestY, width, height);
+
+    position.x = static_cast<sf::Uint32>(bestX);
+    position.y = static_cast<sf::Uint32>(bestY);
+    m_usedSize.x = std::max(m_usedSize.x, position.x + size.x);
+    m_usedSize.y = std::max(m_usedSize.y, position.y + size.y);
+    return true;
+}
+
+const sf::Vector2u& AtlasPacker::getUsedSize() const
+{
+    return m_usedSize;
+}
+
+void AtlasPacker::clear()
+{
+    m_usedSize = sf::Vector2u();
+    m_skyline.clear();
+    m_skyline.emplace_back(0, 0, m_maxSize.x);
+}
+
+//private
+bool AtlasPacker::fits(std::size_t index, sf::Int32 width, sf::Int32 height, sf::Int32& y) const
+{
+    const sf::Int32 x = m_skyline[index].x;
+    if (x + width > m_maxSize.x + m_padding) return false; //padding on the far edge isn't needed
+
+    //the rect may span several levels, in which case it has to sit on the highest
+    sf::Int32 widthLeft = width;
+    y = m_skyline[index].y;
+    while (widthLeft > 0)
+    {
+        if (index == m_skyline.size()) return false;
+
+        y = std::max(y, m_skyline[index].y);
+        if (y + height > m_maxSize.y + m_padding) return false;
+
+        widthLeft -= m_skyline[index].width;
+        ++index;
+    }
+    return true;
+}
+
+void AtlasPacker::addLevel(std::size_t index, sf::Int32 x, sf::Int32 y, sf::Int32 width, sf::Int32 height)
+{
+    m_skyline.insert(m_skyline.begin() + index, SkylineNode(x, y + height, width));
+
+    //shrink or remove any levels now covered by the new one
+    for (auto i = index + 1; i < m_skyline.size(); ++i)
+    {
+        const auto& previous = m_skyline[i - 1];
+        auto& current = m_skyline[i];
+        if (current.x < previous.x + previous.width)
+        {
+            sf::Int32 shrink = previous.x + previous.width - current.x;
+            if (current.width <= shrink)
+            {
+                m_skyline.erase(m_skyline.begin() + i);
+                --i;
+            }
+            else
+            {
+                current.x += shrink;
+                current.width -= shrink;
+                break;
+            }
+        }
+        else break;
+    }
+
+    //merge neighbouring levels of the same height
+    for (auto i = 0u; i + 1 < m_skyline.size(); ++i)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+            --i;
+        }
+    }
+}
@@ -35,37 +35,50 @@ source distribution.
 #include <cmath>
 #include <iostream>
 
-AudioController::AudioController()
-    : m_randomCount (0),
+namespace
+{
+    const std::vector<std::pair<SoundPlayer::AudioId, std::string>> soundFiles =
+    {
+        { SoundPlayer::AudioId::PlayerJump, "res/sound/fx/player_jump.wav" },
+        { SoundPlayer::AudioId::PlayerPickUp, "res/sound/fx/player_pickup.wav" },
+        { SoundPlayer::AudioId::PlayerDrop, "res/sound/fx/player_drop.wav" },
+        { SoundPlayer::AudioId::PlayerGrab, "res/sound/fx/player_grab.wav" },
+        { SoundPlayer::AudioId::PlayerRelease, "res/sound/fx/player_release.wav" },
+        { SoundPlayer::AudioId::PlayerDie, "res/sound/fx/player_die.wav" },
+        { SoundPlayer::AudioId::PlayerSpawn, "res/sound/fx/player_spawn.wav" },
+        { SoundPlayer::AudioId::ItemSpawn, "res/sound/fx/item_spawn.wav" },
+        { SoundPlayer::AudioId::ItemDespawn, "res/sound/fx/item_despawn.wav" },
+        { SoundPlayer::AudioId::ItemExtraLife, "res/sound/fx/item_extra_life.wav" },
+        { SoundPlayer::AudioId::ItemReverseControls, "res/sound/fx/item_reverse_controls.wav" },
+        { SoundPlayer::AudioId::ItemSuperJumpSpeed, "res/sound/fx/item_superjump_superspeed.wav" },
+        { SoundPlayer::AudioId::NpcDie, "res/sound/fx/npc_die.wav" },
+        { SoundPlayer::AudioId::NpcJump, "res/sound/fx/npc_jump.wav" },
+        { SoundPlayer::AudioId::WaterSplash, "res/sound/fx/hit_water.wav" },
+        { SoundPlayer::AudioId::BlockLand, "res/sound/fx/block_drop.wav" },
+        { SoundPlayer::AudioId::BlockDrag, "res/sound/fx/block_drag.wav" },
+        { SoundPlayer::AudioId::HatCrush, "res/sound/fx/hat_crush.wav" },
+        { SoundPlayer::AudioId::HatSpawn, "res/sound/fx/hat_spawn.wav" },
+        { SoundPlayer::AudioId::HatLand, "res/sound/fx/hat_land.wav" },
+        { SoundPlayer::AudioId::KillStreak, "res/sound/fx/killstreak.wav" },
+        { SoundPlayer::AudioId::Bat01, "res/sound/fx/bat01.wav" },
+        { SoundPlayer::AudioId::Bat02, "res/sound/fx/bat02.wav" },
+        { SoundPlayer::AudioId::Bird01, "res/sound/fx/bird01.wav" },
+        { SoundPlayer::AudioId::Bird02, "res/sound/fx/bird02.wav" }
+    };
+
+    const std::string themePath = "res/sound/themes/";
+}
+
+AudioController::AudioController(AssetLoader& assetLoader, bool enabled)
+    : m_enabled     (enabled),
+    m_randomCount   (0),
     m_randomTime    (2.f)
 {
-    //preload sounds
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerJump, "res/sound/fx/player_jump.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerPickUp, "res/sound/fx/player_pickup.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerDrop, "res/sound/fx/player_drop.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerGrab, "res/sound/fx/player_grab.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerRelease, "res/sound/fx/player_release.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerDie, "res/sound/fx/player_die.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::PlayerSpawn, "res/sound/fx/player_spawn.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::ItemSpawn, "res/sound/fx/item_spawn.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::ItemDespawn, "res/sound/fx/item_despawn.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::ItemExtraLife, "res/sound/fx/item_extra_life.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::ItemReverseControls, "res/sound/fx/item_reverse_controls.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::ItemSuperJumpSpeed, "res/sound/fx/item_superjump_superspeed.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::NpcDie, "res/sound/fx/npc_die.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::NpcJump, "res/sound/fx/npc_jump.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::WaterSplash, "res/sound/fx/hit_water.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::BlockLand, "res/sound/fx/block_drop.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::BlockDrag, "res/sound/fx/block_drag.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::HatCrush, "res/sound/fx/hat_crush.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::HatSpawn, "res/sound/fx/hat_spawn.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::HatLand, "res/sound/fx/hat_land.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::KillStreak, "res/sound/fx/killstreak.wav");
+    if (!m_enabled) return;
 
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::Bat01, "res/sound/fx/bat01.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::Bat02, "res/sound/fx/bat02.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::Bird01, "res/sound/fx/bird01.wav");
-    m_soundPlayer.cacheSound(SoundPlayer::AudioId::Bird02, "res/sound/fx/bird02.wav");
+    //sounds should already be decoded by the asset loader
+    for (const auto& s : soundFiles)
+        cacheSound(s.first, s.second, assetLoader);
 
     sf::Listener::setDirection(0.f, 0.f, -1.f);
     m_soundPlayer.setListenerPosition({ 960.f, 540.f }); //set to centre of world for now
@@ -74,6 +87,8 @@ AudioController::AudioController()
 //public
 void AudioController::update()
 {
+    if (!m_enabled) return;
+
     //spawn random ambience etc
     if (m_randomCount > 0 &&
      m_randomClock.getElapsedTime().asSeconds() > m_randomTime)
@@ -94,6 +109,8 @@ void AudioController::update()
 
 void AudioController::onNotify(Subject& s, const Event& e)
 {
+    if (!m_enabled) return;
+
     switch (e.type)
     {
     case Event::Type::Player:
@@ -242,19 +259,52 @@ void AudioController::onNotify(Subject& s, const Event& e)
     }
 }
 
-void AudioController::loadTheme(const std::string& theme)
+void AudioController::loadTheme(const std::string& theme, AssetLoader& assetLoader)
 {
-    std::string path = "res/sound/themes/" + theme + "/random";
+    if (!m_enabled) return;
+
+    auto files = getThemeFiles(theme);
+    auto randStart = static_cast<int>(SoundPlayer::AudioId::Rand01);
+    for (auto i = 0u; i < files.size(); ++i)
+    {
+        cacheSound(static_cast<SoundPlayer::AudioId>(randStart + i), files[i], assetLoader);
+    }
+
+    m_randomCount = (files.size() > 0) ? static_cast<sf::Int32>(files.size()) - 1 : 0;
+}
+
+void AudioController::listAssets(const std::string& theme, AssetLoader::Manifest& manifest)
+{
+    for (const auto& s : soundFiles)
+        manifest.sounds.push_back(s.second);
+
+    auto files = getThemeFiles(theme);
+    manifest.sounds.insert(manifest.sounds.end(), files.begin(), files.end());
+}
+
+//private
+
+std::vector<std::string> AudioController::getThemeFiles(const std::string& theme)
+{
+    std::vector<std::string> files;
+    if (theme.empty()) return files;
+
+    std::string path = themePath + theme + "/random";
     auto result = FileSystem::listFiles(path);
 
     auto randStart = static_cast<int>(SoundPlayer::AudioId::Rand01);
     auto count = std::min(static_cast<int>(SoundPlayer::AudioId::Rand09) - randStart, static_cast<int>(result.size()));
     for (auto i = 0; i < count; ++i)
-    {
-        m_soundPlayer.cacheSound(static_cast<SoundPlayer::AudioId>(randStart + i), path + "/" + result[i]);
-    }
+        files.push_back(path + "/" + result[i]);
 
-    m_randomCount = (count > 0) ? count - 1 : 0;
+    return files;
 }
 
-//private
\ No newline at end of file
+void AudioController::cacheSound(SoundPlayer::AudioId id, const std::string& path, AssetLoader& assetLoader)
+{
+    auto buffer = assetLoader.takeSound(path);
+    if (buffer)
+        m_soundPlayer.cacheSound(id, std::move(buffer));
+    else
+        m_soundPlayer.cacheSound(id, path);
+}
@@ -29,11 +29,13 @@ source distribution.
 #include <Node.hpp>
 #include <Util.hpp>
 #include <BodyBehaviour.hpp>
+#include <JobSystem.hpp>
 
 #include <iostream>
 
-CollisionWorld::CollisionWorld(float gravity)
-    : m_gravity(0.f, gravity)
+CollisionWorld::CollisionWorld(float gravity, JobSystem& jobSystem)
+    : m_jobSystem   (jobSystem),
+    m_gravity       (0.f, gravity)
 {
 
 }
@@ -84,9 +86,15 @@ void CollisionWorld::step(float dt)
     //check for collision pairs and add to list
     //TODO we could narrow this down with space partitioning
     //like a quad tree, but probably not necessary in this game
-    m_collisions.clear();
-    for (const auto& poA : m_bodies)
+    //each body only writes its own sensor and pair list so they run as jobs
+    m_bodyCollisions.resize(m_bodies.size());
+    const std::size_t grainSize = 16u;
+    m_jobSystem.parallelFor(m_bodies.size(), grainSize, [this](std::size_t i)
     {
+        const auto& poA = m_bodies[i];
+        auto& pairs = m_bodyCollisions[i];
+        pairs.clear();
+
         poA->m_footSenseCount = 0u;
         poA->m_footSenseMask = 0u;
         for (const auto& poB : m_bodies)
@@ -98,7 +106,7 @@ void CollisionWorld::step(float dt)
                 {
                     //minmax assures that as the lowest values is always first in the set
                     //that each collision pair only gets inserted once
-                    m_collisions.insert(std::minmax(poA.get(), poB.get()));
+                    pairs.push_back(std::minmax(poA.get(), poB.get()));
                 }
 
                 //secondary collisions with sensor boxes
@@ -109,7 +117,11 @@ void CollisionWorld::step(float dt)
                 }
             }
         }
-    }
+    });
+
+    m_collisions.clear();
+    for (auto i = 0u; i < m_bodies.size(); ++i)
+        m_collisions.insert(m_bodyCollisions[i].begin(), m_bodyCollisions[i].end());
 
     //resolve collision for each pair
     for (const auto& pair : m_collisions)
@@ -29,6 +29,7 @@ source distribution.
 #include <Util.hpp>
 #include <FileSystem.hpp>
 #include <InputMapping.hpp>
+#include <GlyphCache.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -478,12 +479,17 @@ void Console::parseCommand()
 
 void Console::updateText()
 {
-    m_bufferText.setString(prompt + m_commandBuffer + cursor);
+    const std::string buffer = prompt + m_commandBuffer + cursor;
+    m_bufferText.setString(buffer);
     //update output buffer
     std::string output;
     for (const auto& s : m_textBuffer)
         output += s + "\n";
     m_outputText.setString(output);
+
+    //console glyphs ought to be prewarmed so report any which weren't
+    GlyphCache::touch(*m_outputText.getFont(), buffer, charSize);
+    GlyphCache::touch(*m_outputText.getFont(), output, charSize);
 }
 
 void Console::draw(sf::RenderTarget& rt, sf::RenderStates states) const
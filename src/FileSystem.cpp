@@ -40,9 +40,77 @@ source distribution.
 #else
 #include <libgen.h>
 #include <dirent.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #endif //_WIN32
 
+FileSystem::MappedFile::MappedFile(const std::string& path)
+    : m_data    (nullptr),
+    m_size      (0u)
+#ifdef _WIN32
+    ,m_file     (INVALID_HANDLE_VALUE),
+    m_mapping   (nullptr)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return;
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) return;
+
+    m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data) m_size = static_cast<std::size_t>(size.QuadPart);
+}
+#else
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat buf;
+    if (!fstat(fd, &buf) && buf.st_size > 0)
+    {
+        void* data = mmap(nullptr, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(data);
+            m_size = static_cast<std::size_t>(buf.st_size);
+        }
+    }
+    //mapping remains valid after the descriptor is closed
+    close(fd);
+}
+#endif //_WIN32
+
+FileSystem::MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+#endif //_WIN32
+}
+
+bool FileSystem::MappedFile::valid() const
+{
+    return (m_data != nullptr);
+}
+
+const char* FileSystem::MappedFile::data() const
+{
+    return m_data;
+}
+
+std::size_t FileSystem::MappedFile::size() const
+{
+    return m_size;
+}
+
 std::vector<std::string> FileSystem::listFiles(std::string path)
 {
     std::vector<std::string> results;
@@ -118,4 +186,18 @@ std::string FileSystem::getFileExtension(const std::string& path)
         return path.substr(path.find_last_of("."));
     else
         return "";
+}
+
+sf::Uint64 FileSystem::getModifiedTime(const std::string& path)
+{
+    struct stat buf;
+    if (stat(path.c_str(), &buf)) return 0u;
+    return static_cast<sf::Uint64>(buf.st_mtime);
+}
+
+sf::Uint64 FileSystem::getFileSize(const std::string& path)
+{
+    struct stat buf;
+    if (stat(path.c_str(), &buf)) return 0u;
+    return static_cast<sf::Uint64>(buf.st_size);
 }
\ No newline at end of file
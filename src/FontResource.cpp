@@ -26,6 +26,8 @@ source distribution.
 //creates a default font in memory to return when requested font unavailable//
 #include <Resource.hpp>
 
+#include <fstream>
+
 
 FontResource::FontResource()
 {
@@ -76,3 +78,9 @@ std::unique_ptr<sf::Font> FontResource::errorHandle()
 	//Console::lout << " returning default font..." << std::endl;
 	return std::move(std::unique_ptr<sf::Font>(new sf::Font(m_font)));
 }
+
+std::size_t FontResource::sizeOf(const sf::Font&, const std::string& path) const
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	return (file.good()) ? static_cast<std::size_t>(file.tellg()) : 0u;
+}
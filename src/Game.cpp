@@ -37,6 +37,7 @@ source distribution.
 #include <Resource.hpp>
 #include <FileSystem.hpp>
 #include <InputMapping.hpp>
+#include <GlyphCache.hpp>
 
 #include <SFML/Graphics/Font.hpp>
 
@@ -44,10 +45,14 @@ source distribution.
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <iostream>
+#include <algorithm>
 
 namespace
 {
-    const float timePerFrame = 1.f / 60.f;
+    //after a long frame (loading, dragging the window) remaining time is
+    //dropped rather than simulated, which would only make the next frame longer
+    const sf::Uint8 maxSubSteps = 5u;
 
     sf::Clock frameClock;
     float timeSinceLastUpdate = 0.f;
@@ -55,20 +60,60 @@ namespace
     GameData gameData;
 
     const std::string windowTitle = "CRUSH 0.5";
+
+    //the profiler overlay is rebuilt every few frames so it stays readable
+    const sf::Uint32 profilerOverlayInterval = 10u;
+    const std::size_t profilerOverlayFrames = 60u;
+    //frames allowed to fill caches and pools before alloc_assert applies
+    const std::size_t allocationWarmupFrames = 300u;
+
+    //bytes of unreferenced resources kept resident before eviction
+    const std::size_t defaultTextureBudget = 256u * 1024u * 1024u;
+    const std::size_t defaultFontBudget = 8u * 1024u * 1024u;
+
+    //printable ascii at each size used by the HUD, menus and console.
+    //more can be added with prewarm_glyphs in a .con file
+    const std::vector<GlyphCache::Range> defaultGlyphRanges =
+    {
+        { 24u, 32u, 126u, false }, //fps
+        { 24u, 32u, 126u, true }, //score messages
+        { 25u, 32u, 126u, false }, //console
+        { 30u, 32u, 126u, false }, //scores, UI
+        { 32u, 32u, 126u, false }, //ticker
+        { 36u, 32u, 126u, false },
+        { 40u, 32u, 126u, false },
+        { 80u, 32u, 126u, false },
+        { 100u, 32u, 126u, false }
+    };
 }
 
-Game::Game()
-    : m_videoSettings   (),
-    m_renderWindow      (m_videoSettings.videoMode, windowTitle, m_videoSettings.windowStyle),
+Game::Game(bool headless)
+    : m_headless        (headless),
+    m_videoSettings     (),
+    m_shaderResource    (!headless),
     m_console           (getFont("res/fonts/VeraMono.ttf")),
     m_stateStack        (State::Context(m_renderWindow, *this, gameData)),
-    m_fpsText           ("", getFont("res/fonts/VeraMono.ttf"), 24u),
-    m_showFps           (false)
+    m_fpsText           (getFont("res/fonts/VeraMono.ttf")),
+    m_fpsTextId         (m_fpsText.addText("", 24u)),
+    m_showFps           (false),
+#ifdef CRUSH_PROFILER
+    m_profilerOverlay   (getFont("res/fonts/VeraMono.ttf")),
+    m_showProfiler      (false),
+    m_profilerFrameCount(0u),
+#endif //CRUSH_PROFILER
+    m_interpolationAlpha(1.f),
+    m_tickTime          (1.f / 60.f)
 {
-    registerStates();
-    m_stateStack.pushState(States::ID::Title);
+    m_textureResource.setBudget(defaultTextureBudget);
+    m_fontResource.setBudget(defaultFontBudget);
 
-    m_renderWindow.setVerticalSyncEnabled(m_videoSettings.vSync);
+    registerStates();
+    if (!m_headless)
+    {
+        m_renderWindow.create(m_videoSettings.videoMode, windowTitle, m_videoSettings.windowStyle);
+        m_renderWindow.setVerticalSyncEnabled(m_videoSettings.vSync);
+        m_stateStack.pushState(States::ID::Title);
+    }
     //store available modes and remove unusable
     m_videoSettings.availableVideoModes = sf::VideoMode::getFullscreenModes();
     m_videoSettings.availableVideoModes.erase(std::remove_if(m_videoSettings.availableVideoModes.begin(), m_videoSettings.availableVideoModes.end(),
@@ -80,10 +125,17 @@ Game::Game()
     //bind commands to console
     registerConCommands();
 
+    //rasterise glyphs up front rather than mid game
+    if (!m_headless)
+    {
+        for (const auto& range : defaultGlyphRanges)
+            GlyphCache::prewarm(getFont("res/fonts/VeraMono.ttf"), range);
+    }
+
     update = std::bind(&Game::updateGame, this, std::placeholders::_1);
 
-    m_fpsText.setColor(sf::Color::Yellow);
-    m_fpsText.setPosition(20.f, 1050.f);
+    m_fpsText.setColour(m_fpsTextId, sf::Color::Yellow);
+    m_fpsText.setPosition(m_fpsTextId, { 20.f, 1050.f });
 }
 
 //public
@@ -94,22 +146,46 @@ void Game::run()
     m_console.exec("bind escape quit");
     m_console.exec("exec default.con");
 
+    PROFILE_THREAD_NAME("main");
     frameClock.restart();
     while (m_renderWindow.isOpen())
     {
         float elapsedTime = frameClock.restart().asSeconds();
         timeSinceLastUpdate += elapsedTime;
 
-        m_fpsText.setString(std::to_string(1.f / elapsedTime));
+        if (m_showFps) m_fpsText.setString(m_fpsTextId, std::to_string(1.f / elapsedTime));
 
-        while (timeSinceLastUpdate > timePerFrame)
+        sf::Uint8 steps = 0u;
+        while (timeSinceLastUpdate > m_tickTime && steps++ < maxSubSteps)
         {
-            timeSinceLastUpdate -= timePerFrame;
+            timeSinceLastUpdate -= m_tickTime;
+
+            {
+                PROFILE_SCOPE("Game::handleEvents");
+                handleEvents();
+            }
+            {
+                PROFILE_SCOPE("Game::update");
+                update(m_tickTime);
+            }
+        }
+
+        if (timeSinceLastUpdate > m_tickTime)
+            timeSinceLastUpdate = std::fmod(timeSinceLastUpdate, m_tickTime);
 
-            handleEvents();
-            update(timePerFrame);
+        m_interpolationAlpha = timeSinceLastUpdate / m_tickTime;
+        {
+            PROFILE_SCOPE("Game::draw");
+            draw();
         }
-        draw();
+        Resource::advanceFrame();
+        m_jobSystem.endFrame();
+        PROFILE_END_FRAME();
+
+#ifdef CRUSH_PROFILER
+        if (m_showProfiler && ++m_profilerFrameCount % profilerOverlayInterval == 0)
+            m_profilerOverlay.update(profilerOverlayFrames);
+#endif //CRUSH_PROFILER
     }
 
     //write console config file
@@ -118,6 +194,80 @@ void Game::run()
     m_musicPlayer.stop();
 }
 
+int Game::runHeadless(const std::string& map, sf::Uint32 tickCount)
+{
+    gameData.mapList = FileSystem::listFiles("res/maps");
+    gameData.mapList.erase(std::remove_if(gameData.mapList.begin(), gameData.mapList.end(),
+        [](const std::string& s)
+    {
+        return (FileSystem::getFileExtension(s) != ".crm");
+    }),
+        gameData.mapList.end());
+
+    if (gameData.mapList.empty())
+    {
+        std::cerr << "no maps found in res/maps" << std::endl;
+        return 1;
+    }
+
+    gameData.mapIndex = 0u;
+    if (!map.empty())
+    {
+        auto result = std::find_if(gameData.mapList.begin(), gameData.mapList.end(),
+            [&map](const std::string& s)
+        {
+            return Util::String::toLower(s) == Util::String::toLower(map) + ".crm";
+        });
+        if (result == gameData.mapList.end())
+        {
+            std::cerr << "map " << map << " not found" << std::endl;
+            return 1;
+        }
+        gameData.mapIndex = static_cast<sf::Uint16>(std::distance(gameData.mapList.begin(), result));
+    }
+
+    //pushing is deferred until the stack next updates
+    sf::Clock clock;
+    m_stateStack.pushState(States::ID::Game);
+    m_stateStack.update(0.f);
+    const float loadTime = clock.restart().asSeconds();
+
+    for (auto i = 0u; i < tickCount; ++i)
+    {
+        m_stateStack.update(m_tickTime);
+        Resource::advanceFrame();
+        m_jobSystem.endFrame();
+        PROFILE_END_FRAME();
+    }
+    const float runTime = clock.getElapsedTime().asSeconds();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << gameData.mapList[gameData.mapIndex] << " loaded in " << loadTime << "s" << std::endl;
+    std::cout << tickCount << " ticks in " << runTime << "s, ";
+    if (tickCount > 0 && runTime > 0.f)
+        std::cout << (runTime * 1000.f) / tickCount << "ms per tick, " << tickCount / runTime << " ticks per second";
+    std::cout << std::endl;
+
+    //the game state prints the time spent in each
+    //simulation task when it's destroyed along with the game
+    return 0;
+}
+
+bool Game::isHeadless() const
+{
+    return m_headless;
+}
+
+float Game::getInterpolationAlpha() const
+{
+    return m_interpolationAlpha;
+}
+
+float Game::getTickTime() const
+{
+    return m_tickTime;
+}
+
 void Game::pause()
 {
     update = std::bind(&Game::pauseGame, this, std::placeholders::_1);
@@ -155,6 +305,11 @@ Console& Game::getConsole()
     return m_console;
 }
 
+JobSystem& Game::getJobSystem()
+{
+    return m_jobSystem;
+}
+
 MusicPlayer& Game::getMusicPlayer()
 {
     return m_musicPlayer;
@@ -200,7 +355,18 @@ void Game::draw()
     if (m_showFps)
         m_renderWindow.draw(m_fpsText);
 
-    m_renderWindow.display();
+#ifdef CRUSH_PROFILER
+    if (m_showProfiler)
+    {
+        PROFILE_SCOPE("Profiler::Overlay");
+        m_renderWindow.draw(m_profilerOverlay);
+    }
+#endif //CRUSH_PROFILER
+
+    {
+        PROFILE_SCOPE("Game::display");
+        m_renderWindow.display();
+    }
 }
 
 void Game::registerStates()
@@ -276,6 +442,30 @@ void Game::registerConCommands()
     cd.help = "load next map in the list";
     m_console.addItem("nextmap", cd);
 
+    //----set simulation rate----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (l.empty()) return "usage: set_tick_rate <ticks per second>";
+
+        float rate = 0.f;
+        try
+        {
+            rate = std::stof(l[0]);
+        }
+        catch (...)
+        {
+            return l[0] + ": invalid rate";
+        }
+        if (rate < 10.f || rate > 240.f) return "tick rate must be between 10 and 240";
+
+        m_tickTime = 1.f / rate;
+        timeSinceLastUpdate = 0.f;
+        flags |= Console::CommandFlag::Valid;
+        return "simulation running at " + l[0] + " ticks per second";
+    };
+    cd.help = "param <rate> set the number of simulation updates per second. drawing is interpolated between updates";
+    m_console.addItem("set_tick_rate", cd);
+
     //----display frame rate----//
     cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
     {
@@ -285,6 +475,202 @@ void Game::registerConCommands()
     cd.help = "toggle fps display";
     m_console.addItem("show_fps", cd);
 
+    //----list texture memory usage----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        auto report = m_textureResource.getMemoryReport();
+        for (const auto& line : report)
+            m_console.print(line);
+        return "";
+    };
+    cd.help = "list cached textures and the memory shared by handles";
+    m_console.addItem("texture_report", cd);
+
+    //----list resident resources----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        std::vector<std::string> list;
+        if (l.empty() || l[0] == "textures")
+            list = m_textureResource.listResources();
+        else if (l[0] == "fonts")
+            list = m_fontResource.listResources();
+        else
+            return "usage: list_resources <textures|fonts>";
+
+        for (const auto& line : list)
+            m_console.print(line);
+        return "";
+    };
+    cd.help = "list resident textures or fonts with size and last use frame";
+    m_console.addItem("list_resources", cd);
+
+    //----set resource memory budget----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (l.size() < 2) return "usage: resource_budget <textures|fonts> <megabytes>";
+
+        std::size_t bytes = 0u;
+        try
+        {
+            bytes = static_cast<std::size_t>(std::stoul(l[1])) * 1024u * 1024u;
+        }
+        catch (...)
+        {
+            return l[1] + ": invalid size";
+        }
+
+        if (l[0] == "textures")
+            m_textureResource.setBudget(bytes);
+        else if (l[0] == "fonts")
+            m_fontResource.setBudget(bytes);
+        else
+            return l[0] + ": unknown resource type";
+
+        flags |= Console::CommandFlag::Valid;
+        return "set " + l[0] + " budget to " + l[1] + "MB (0 is unlimited)";
+    };
+    cd.help = "set the memory budget in MB before unused resources are evicted";
+    m_console.addItem("resource_budget", cd);
+
+    //----prewarm additional glyphs----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (l.empty()) return "usage: prewarm_glyphs <size> [first] [last] [bold]";
+
+        GlyphCache::Range range = { 0u, 32u, 126u, false };
+        try
+        {
+            range.charSize = static_cast<sf::Uint32>(std::stoul(l[0]));
+            if (l.size() > 1) range.first = static_cast<sf::Uint32>(std::stoul(l[1]));
+            if (l.size() > 2) range.last = static_cast<sf::Uint32>(std::stoul(l[2]));
+        }
+        catch (...)
+        {
+            return "prewarm_glyphs: invalid parameter";
+        }
+        range.bold = (l.size() > 3 && l[3] == "bold");
+        if (range.charSize == 0 || range.first > range.last) return "prewarm_glyphs: invalid range";
+
+        GlyphCache::prewarm(getFont("res/fonts/VeraMono.ttf"), range);
+        return "prewarmed glyphs " + std::to_string(range.first) + " to " + std::to_string(range.last)
+            + " at size " + l[0] + (range.bold ? " bold" : "");
+    };
+    cd.help = "params <size> [first] [last] [bold] rasterise a range of glyphs so they are not uploaded during play";
+    m_console.addItem("prewarm_glyphs", cd);
+
+    //----report glyphs uploaded after prewarming----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        const auto uploads = GlyphCache::getUploads();
+        for (const auto& u : uploads)
+            m_console.print(u);
+        return std::to_string(GlyphCache::getPrewarmedCount()) + " glyphs prewarmed, "
+            + std::to_string(uploads.size()) + " uploaded since";
+    };
+    cd.help = "list glyphs which were rasterised on first use instead of being prewarmed";
+    m_console.addItem("glyph_report", cd);
+
+    //----report job system counters----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        const auto& stats = m_jobSystem.getLastFrameStats();
+        return std::to_string(m_jobSystem.getWorkerCount()) + " workers. last frame: "
+            + std::to_string(stats.jobsRun) + " jobs run, "
+            + std::to_string(stats.jobsStolen) + " stolen, "
+            + std::to_string(stats.parallelFors) + " parallel fors";
+    };
+    cd.help = "show the number of job system workers and jobs run in the last frame";
+    m_console.addItem("job_stats", cd);
+
+#ifdef CRUSH_PROFILER
+    //----toggle profiler overlay----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        m_showProfiler = !m_showProfiler;
+        if (m_showProfiler) m_profilerOverlay.update(profilerOverlayFrames);
+        return "";
+    };
+    cd.help = "toggle the frame profiler overlay";
+    m_console.addItem("show_profiler", cd);
+
+    //----write profiler history to csv----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        std::size_t frameCount = Profiler::getFrameCount();
+        if (!l.empty())
+        {
+            try
+            {
+                frameCount = static_cast<std::size_t>(std::stoul(l[0]));
+            }
+            catch (...)
+            {
+                return l[0] + ": invalid frame count";
+            }
+        }
+        const std::string path = (l.size() > 1) ? l[1] : "profile.csv";
+
+        if (!Profiler::writeCsv(path, frameCount))
+            return "failed to write " + path;
+
+        return "wrote " + std::to_string(std::min(frameCount, Profiler::getFrameCount())) + " frames to " + path;
+    };
+    cd.help = "params [frames] [file] write the last frames of profiler timings as csv. defaults to all recorded frames and profile.csv";
+    m_console.addItem("profiler_dump", cd);
+
+    //----write recent scopes from all threads as a trace----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        const std::string path = l.empty() ? "trace.json" : l[0];
+        if (!Profiler::writeTrace(path))
+            return "failed to write " + path;
+        return "wrote " + path + ", open it in chrome://tracing";
+    };
+    cd.help = "param [file] write the last few seconds of profiler scopes from every thread in chrome trace format. defaults to trace.json";
+    m_console.addItem("trace_dump", cd);
+
+    //----write a trace when a frame takes too long----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (l.empty()) return "spike threshold is " + std::to_string(Profiler::getSpikeThreshold()) + "ms";
+
+        float threshold = 0.f;
+        try
+        {
+            threshold = std::stof(l[0]);
+        }
+        catch (...)
+        {
+            return l[0] + ": invalid threshold";
+        }
+
+        Profiler::setSpikeThreshold(threshold);
+        flags |= Console::CommandFlag::Valid;
+        return (threshold > 0.f) ? "frames over " + l[0] + "ms will write spike_<frame>.json" : "spike traces disabled";
+    };
+    cd.help = "param <milliseconds> write a trace whenever a frame takes longer than this. 0 disables";
+    m_console.addItem("trace_spike", cd);
+
+#ifdef CRUSH_TRACK_ALLOCATIONS
+    //----abort if steady state frames allocate----//
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (l.empty()) return "usage: alloc_assert <off|scope path...>";
+
+        if (l[0] == "off")
+        {
+            Profiler::setAllocationAssert({}, 0u);
+            return "allocation assert disabled";
+        }
+
+        Profiler::setAllocationAssert(l, allocationWarmupFrames);
+        return "aborting on allocations after " + std::to_string(allocationWarmupFrames) + " frames";
+    };
+    cd.help = "params <off|scope path...> abort if the given profiler scopes allocate once warmed up, eg Game::update/GameState::update GameState::simulate";
+    m_console.addItem("alloc_assert", cd);
+#endif //CRUSH_TRACK_ALLOCATIONS
+#endif //CRUSH_PROFILER
+
     //---set a key to a player command---//
     cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
     {
@@ -30,12 +30,15 @@ source distribution.
 #include <Util.hpp>
 #include <Map.hpp>
 #include <Light.hpp>
+#include <FileSystem.hpp>
+#include <Profiler.hpp>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/Shader.hpp>
 
 #include <iostream>
+#include <sstream>
 
 namespace
 {
@@ -55,15 +58,25 @@ GameState::GameState(StateStack& stack, Context context)
     : State             (stack, context),
     m_textureResource   (context.gameInstance.getTextureResource()),
     m_shaderResource    (context.gameInstance.getShaderResource()),
-    m_collisionWorld    (70.f),
+    m_headless          (context.gameInstance.isHeadless()),
+    m_map               ("res/maps/" + context.gameData.mapList[context.gameData.mapIndex]),
+    m_assetLoader       (preloadAssets(), m_textureResource, context.jobSystem, [this](float progress){ setLoadingProgress(progress); }),
+    m_collisionWorld    (70.f, context.jobSystem),
     m_npcController     (m_commandStack, m_textureResource, m_shaderResource),
-    m_scoreBoard        (stack, context),
-    m_particleController(m_textureResource, m_shaderResource),
-    m_mapController     (m_commandStack, m_textureResource, m_shaderResource)
+    m_scoreBoard        (context),
+    m_particleController(m_textureResource, m_shaderResource, context.jobSystem),
+    m_mapController     (m_commandStack, m_textureResource, m_shaderResource, context.jobSystem),
+    m_audioController   (m_assetLoader, !m_headless),
+    m_frontSnapshot     (&m_snapshots[0]),
+    m_backSnapshot      (&m_snapshots[1]),
+    m_gameOver          (false),
+    m_tickPending       (false),
+    m_quitSimulation    (false),
+    m_tickDt            (0.f),
+    m_taskGraph         (context.jobSystem)
 {
-    //launch loading window
-    launchLoadingScreen();
-    
+    PROFILE_SCOPE("GameState::load");
+
     //build world  
     Scene::defaultCamera.setView(getContext().defaultView);
     m_scene.addShader(m_shaderResource.get(Shader::Type::FlatShaded));
@@ -83,9 +96,6 @@ GameState::GameState(StateStack& stack, Context context)
     lightDrawable.setOutlineColor(sf::Color(255u, 255u, 255u, 11u));
     lightDrawable.setOutlineThickness(80.f);
 
-    //parse map
-    Map map("res/maps/" + context.gameData.mapList[context.gameData.mapIndex]);
-
     //set up controllers
     m_players.reserve(2);
     m_players.emplace_back(m_commandStack, Category::PlayerOne, m_textureResource, m_shaderResource.get(Shader::Type::NormalMapSpecular));
@@ -96,16 +106,20 @@ GameState::GameState(StateStack& stack, Context context)
     std::function<void(const sf::Vector2f&, Player&)> playerSpawnFunc = std::bind(&GameState::addPlayer, this, std::placeholders::_1, std::placeholders::_2);
     m_players[0].setSpawnFunction(playerSpawnFunc);
     m_players[1].setSpawnFunction(playerSpawnFunc);
-    m_players[0].setSpawnPosition(map.getPlayerOneSpawn());
-    m_players[1].setSpawnPosition(map.getPlayerTwoSpawn());
+    m_players[0].setSpawnPosition(m_map.getPlayerOneSpawn());
+    m_players[1].setSpawnPosition(m_map.getPlayerTwoSpawn());
 
     std::function<void(const sf::Vector2f&, const sf::Vector2f&)> npcSpawnFunc = std::bind(&GameState::addNpc, this, std::placeholders::_1, std::placeholders::_2);
     m_npcController.setSpawnFunction(npcSpawnFunc);
-    m_npcController.setNpcCount(map.getNpcCount());
+    m_npcController.setNpcCount(m_map.getNpcCount());
 
     std::function<void(const Map::Node&)> mapSpawnFunc = std::bind(&GameState::addMapBody, this, std::placeholders::_1);
     m_mapController.setSpawnFunction(mapSpawnFunc);
-    m_mapController.loadMap(map);
+    //particle collision has to cover maps larger than the screen
+    auto mapBounds = m_map.getBounds();
+    if (mapBounds.width > 0.f && mapBounds.height > 0.f)
+        m_particleController.getCollisionGrid().resize(mapBounds);
+    m_mapController.loadMap(m_map);
 
     m_scoreBoard.addObserver(m_players[0]);
     m_scoreBoard.addObserver(m_players[1]);
@@ -114,23 +128,23 @@ GameState::GameState(StateStack& stack, Context context)
         m_scoreBoard.enablePlayer(Category::PlayerOne);
     if (context.gameData.playerTwo.enabled)
         m_scoreBoard.enablePlayer(Category::PlayerTwo);
-    m_scoreBoard.setMaxNpcs(map.getNpcTotal());
+    m_scoreBoard.setMaxNpcs(m_map.getNpcTotal());
 
     m_scene.setLayerDrawable(m_mapController.getDrawable(MapController::MapDrawable::Solid), Scene::Solid);
     m_scene.setLayerDrawable(m_mapController.getDrawable(MapController::MapDrawable::RearDetail), Scene::RearDetail);
     m_scene.setLayerDrawable(m_mapController.getDrawable(MapController::MapDrawable::FrontDetail), Scene::FrontDetail);
     m_scene.setLayerDrawable(m_mapController.getDrawable(MapController::MapDrawable::Background), Scene::Background);
-    m_scene.setAmbientColour(map.getAmbientColour());
-    m_scene.setSunLightColour(map.getSunlightColour());
+    m_scene.setAmbientColour(m_map.getAmbientColour());
+    m_scene.setSunLightColour(m_map.getSunlightColour());
 
     //sf::Clock c;
     //while (c.getElapsedTime().asSeconds() < 5.f){}
 
-    std::string theme = map.getAudioTheme();
+    std::string theme = m_map.getAudioTheme();
     std::string music;
-    if (!theme.empty())
+    if (!theme.empty() && !m_headless)
     {
-        m_audioController.loadTheme(theme);
+        m_audioController.loadTheme(theme, m_assetLoader);
         music = "res/sound/themes/" + theme + "/main.ogg";
     }
 
@@ -139,56 +153,82 @@ GameState::GameState(StateStack& stack, Context context)
     if (!music.empty())
         context.gameInstance.getMusicPlayer().play(music);
 
+    buildTaskGraph();
     registerConsoleCommands();
+    if (m_headless) return;
+
     context.renderWindow.setMouseCursorVisible(false);
+
+    //so there's something to draw before the first tick completes
+    m_scene.update(0.f);
+    buildSnapshot(*m_frontSnapshot);
+    m_simThread = std::thread(&GameState::runSimulation, this);
 }
 
 GameState::~GameState()
 {
-    getContext().renderWindow.setMouseCursorVisible(true);
+    {
+        std::lock_guard<std::mutex> lock(m_simMutex);
+        m_quitSimulation = true;
+    }
+    m_simCondition.notify_all();
+    if (m_simThread.joinable())
+        m_simThread.join();
+
+    if (m_headless)
+        std::cout << m_taskGraph.report();
+    else
+        getContext().renderWindow.setMouseCursorVisible(true);
+
     unregisterConsoleCommands();
 }
 
 bool GameState::update(float dt)
-{    
-    while (!m_commandStack.empty())
-        m_scene.executeCommand(m_commandStack.pop(), dt);
-
-    //update players
-    for (auto& p : m_players)
-        p.update(dt);
-
-    //update AI
-    m_npcController.update(dt);
-
-    //update collision detection
-    m_collisionWorld.step(dt);
-
-    //update particles
-    m_particleController.update(dt);
-
-    //map controller (bonuses etc)
-    m_mapController.update(dt);
+{
+    PROFILE_SCOPE("GameState::update");
 
-    //do sounds
-    m_audioController.update();
+    if (m_headless)
+    {
+        simulate(dt);
+        return true;
+    }
 
-    //updates the scene lighting
-    m_scene.update(dt);
+    //finish the tick in flight and draw its results
+    {
+        PROFILE_SCOPE("GameState::waitForTick");
+        waitForTick();
+    }
+    std::swap(m_frontSnapshot, m_backSnapshot);
+    m_tickClock.restart();
 
-    //update scoreboard
-    m_scoreBoard.update(dt);
+    //the state stack isn't thread safe so the scoreboard leaves this to us
+    if (m_scoreBoard.gameOver() && !m_gameOver)
+    {
+        requestStackPush(States::ID::GameOver);
+        m_gameOver = true;
+    }
 
-    //make sure shader bindings are up to date
-    m_shaderResource.updateBindings();
+    //then start the next tick, which runs while the front snapshot is drawn
+    {
+        std::lock_guard<std::mutex> lock(m_simMutex);
+        m_tickDt = dt;
+        m_tickPending = true;
+    }
+    m_simCondition.notify_all();
     return true;
 }
 
 void GameState::draw()
 {  
-    getContext().renderWindow.draw(m_scene);
-    getContext().renderWindow.draw(m_particleController);
-    getContext().renderWindow.draw(m_scoreBoard);
+    PROFILE_SCOPE("GameState::draw");
+
+    auto& game = getContext().gameInstance;
+    const bool paused = m_tickClock.getElapsedTime().asSeconds() > game.getTickTime() * 2.f;
+    m_frontSnapshot->setInterpolationAlpha(paused ? 1.f : game.getInterpolationAlpha());
+
+    //make sure shader bindings are up to date
+    m_shaderResource.updateBindings();
+    getContext().renderWindow.draw(*m_frontSnapshot);
 }
 
 bool GameState::handleEvent(const sf::Event& evt)
@@ -238,6 +278,116 @@ bool GameState::handleEvent(const sf::Event& evt)
 
 
 //private
+void GameState::buildTaskGraph()
+{
+    //raising events or spawning nodes notifies every observer, so anything
+    //which may do so also writes the data belonging to each of them.
+    //observers may queue commands in response
+    const std::vector<std::string> observers = { "commands", "scene", "bodies", "players", "npcs", "particles", "audio", "scoreboard", "map" };
+
+    m_taskGraph.addTask("commands", [this](float dt)
+    {
+        while (!m_commandStack.empty())
+            m_scene.executeCommand(m_commandStack.pop(), dt);
+    }, {}, observers);
+
+    m_taskGraph.addTask("players", [this](float dt)
+    {
+        for (auto& p : m_players)
+            p.update(dt);
+    }, {}, observers);
+
+    m_taskGraph.addTask("npcs", [this](float dt)
+    {
+        m_npcController.update(dt);
+    }, {}, observers);
+
+    m_taskGraph.addTask("collision", [this](float dt)
+    {
+        m_collisionWorld.step(dt);
+    }, {}, observers);
+
+    //bonuses etc
+    m_taskGraph.addTask("map", [this](float dt)
+    {
+        m_mapController.update(dt);
+    }, {}, observers);
+
+    m_taskGraph.addTask("particles", [this](float dt)
+    {
+        m_particleController.update(dt);
+    }, { "scene" }, { "particles", "water" });
+
+    m_taskGraph.addTask("map drawables", [this](float dt)
+    {
+        m_mapController.updateDrawables(dt);
+    }, {}, { "map drawables", "water" });
+
+    m_taskGraph.addTask("audio", [this](float)
+    {
+        m_audioController.update();
+    }, {}, { "audio" });
+
+    m_taskGraph.addTask("scoreboard", [this](float dt)
+    {
+        m_scoreBoard.update(dt);
+    }, {}, { "scoreboard" });
+
+    //updates the scene lighting and removes dead nodes
+    m_taskGraph.addTask("scene", [this](float dt)
+    {
+        m_scene.update(dt);
+    }, {}, { "scene", "lights" });
+}
+
+void GameState::simulate(float dt)
+{
+    PROFILE_SCOPE("GameState::simulate");
+
+    //drawing interpolates from here to the end of the tick
+    m_scene.storeTransforms();
+
+    m_taskGraph.run(dt);
+}
+
+void GameState::buildSnapshot(RenderSnapshot& snapshot) const
+{
+    PROFILE_SCOPE("GameState::buildSnapshot");
+
+    snapshot.clear();
+    m_scene.snapshot(snapshot);
+    m_particleController.snapshot(snapshot);
+    m_scoreBoard.snapshot(snapshot);
+}
+
+void GameState::runSimulation()
+{
+    PROFILE_THREAD_NAME("simulation");
+
+    std::unique_lock<std::mutex> lock(m_simMutex);
+    while (true)
+    {
+        m_simCondition.wait(lock, [this](){ return m_tickPending || m_quitSimulation; });
+        if (m_quitSimulation) return;
+
+        const float dt = m_tickDt;
+        lock.unlock();
+
+        simulate(dt);
+        buildSnapshot(*m_backSnapshot);
+
+        lock.lock();
+        m_tickPending = false;
+        m_simCondition.notify_all();
+    }
+}
+
+void GameState::waitForTick()
+{
+    std::unique_lock<std::mutex> lock(m_simMutex);
+    m_simCondition.wait(lock, [this](){ return !m_tickPending; });
+}
+
 void GameState::addBlock(const sf::Vector2f& position, const sf::Vector2f& size)
 {
     auto blockNode = std::make_unique<Node>("blockNode");
@@ -304,6 +454,7 @@ void GameState::addMapBody(const Map::Node& n)
         node->setPosition(n.position);
         node->setCollisionBody(m_collisionWorld.addBody(CollisionWorld::Body::Solid, n.size));
         m_scene.addNode(node, Scene::Solid);
+        m_particleController.getCollisionGrid().addSolid({ n.position, n.size });
     }
         break;
     case Category::Water:
@@ -316,6 +467,7 @@ void GameState::addMapBody(const Map::Node& n)
         node->setCollisionBody(m_collisionWorld.addBody(CollisionWorld::Body::Water, n.size));
         node->addObserver(m_particleController);
         m_scene.addNode(node, Scene::Water);
+        m_particleController.getCollisionGrid().addWater({ n.position, n.size }, *drawable);
     }
         break;
     case Category::Item:
@@ -343,11 +495,15 @@ void GameState::addMapBody(const Map::Node& n)
         auto node = std::make_unique<Node>();
         node->setCategory(Category::Light);
         //TODO magix0r numb0rz
+        //the scene only has so many lights, the rest are just drawn
         auto light = m_scene.addLight(colourToVec3(n.colour), 700.f);
-        light->setDepth(50.f);
-        node->setLight(light);
+        if (light)
+        {
+            light->setDepth(50.f);
+            node->setLight(light);
+            node->addObserver(*light);
+        }
         node->setPosition(n.position + (n.size / 2.f));
-        node->addObserver(*light);
         node->setDrawable(&lightDrawable);
         node->setBlendMode(sf::BlendAlpha);
 
@@ -378,8 +534,11 @@ void GameState::addMapBody(const Map::Node& n)
         node->setCollisionBody(m_collisionWorld.addBody(CollisionWorld::Body::Type::FreeForm, n.size));
         node->setCategory(n.type);
         auto light = m_scene.addLight(sf::Vector3f(1.f, 0.9f, 0.f), 200.f);
-        light->setDepth(50.f);
-        node->setLight(light);
+        if (light)
+        {
+            light->setDepth(50.f);
+            node->setLight(light);
+        }
 
         node->addObserver(m_particleController);
         node->addObserver(m_audioController);
@@ -405,6 +564,28 @@ void GameState::addMapBody(const Map::Node& n)
     }
 }
 
+AssetLoader::Manifest GameState::preloadAssets()
+{
+    //show the loading screen first so progress is visible
+    if (!m_headless) launchLoadingScreen();
+
+    AssetLoader::Manifest manifest;
+    for (const std::string path : { "res/textures/characters/", "res/textures/particles/" })
+    {
+        auto files = FileSystem::listFiles(path);
+        for (const auto& f : files)
+        {
+            auto ext = FileSystem::getFileExtension(f);
+            if (ext == ".png" || ext == ".tga")
+                manifest.textures.push_back(path + f);
+        }
+    }
+    MapController::listAssets(m_map, manifest);
+    if (!m_headless) AudioController::listAssets(m_map.getAudioTheme(), manifest);
+
+    return manifest;
+}
+
 void GameState::registerConsoleCommands()
 {
     auto& console = getContext().gameInstance.getConsole();
@@ -414,6 +595,8 @@ void GameState::registerConsoleCommands()
         if (l.size() < 2)
             return "give: not enough parameters";
 
+        waitForTick();
+
         //raise player event with item info and use command stack
         //to target player and raise event from node
         
@@ -481,12 +664,50 @@ void GameState::registerConsoleCommands()
     cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
     {
         if (!l.size()) return "missing parameter: true or false";
+        waitForTick();
         m_npcController.enable((l[0] == "true") ? true : false);
         return "";
     };
     cd.help = "param: true / false";
     m_consoleCommands.push_back("npc_enable");
     console.addItem(m_consoleCommands.back(), cd);
+
+    cd.action = [this](Console::CommandList, sf::Uint32&)->std::string
+    {
+        waitForTick();
+        std::stringstream ss(m_taskGraph.dump());
+        std::string line;
+        while (std::getline(ss, line))
+            getContext().gameInstance.getConsole().print(line);
+        return "";
+    };
+    cd.help = "print the simulation tasks, the data they use and their dependencies";
+    m_consoleCommands.push_back("task_graph_dump");
+    console.addItem(m_consoleCommands.back(), cd);
+
+    cd.action = [this](Console::CommandList, sf::Uint32&)->std::string
+    {
+        waitForTick();
+        std::stringstream ss(m_taskGraph.report());
+        std::string line;
+        while (std::getline(ss, line))
+            getContext().gameInstance.getConsole().print(line);
+        return "";
+    };
+    cd.help = "print the number of times each simulation task has run and the time it took";
+    m_consoleCommands.push_back("task_graph_report");
+    console.addItem(m_consoleCommands.back(), cd);
+
+    cd.action = [this](Console::CommandList l, sf::Uint32& flags)->std::string
+    {
+        if (!l.size()) return "missing parameter: true or false";
+        waitForTick();
+        m_taskGraph.setParallel(l[0] == "true");
+        return (m_taskGraph.parallel()) ? "simulation tasks run in parallel" : "simulation tasks run in sequence";
+    };
+    cd.help = "param: true / false. false runs the simulation tasks one at a time";
+    m_consoleCommands.push_back("task_graph_parallel");
+    console.addItem(m_consoleCommands.back(), cd);
 }
 
 void GameState::unregisterConsoleCommands()
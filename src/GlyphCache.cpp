@@ -0,0 +1,98 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <GlyphCache.hpp>
+
+#include <SFML/Graphics/Font.hpp>
+
+#include <unordered_set>
+#include <map>
+#include <mutex>
+#include <iostream>
+
+namespace
+{
+    //text may be laid out by more than one thread
+    std::mutex mutex;
+    std::map<const sf::Font*, std::unordered_set<sf::Uint64>> residentGlyphs;
+    std::vector<std::string> uploads;
+    sf::Uint32 prewarmedCount = 0u;
+
+    sf::Uint64 key(sf::Uint32 codePoint, sf::Uint32 charSize, bool bold)
+    {
+        return (static_cast<sf::Uint64>(codePoint) << 32) | (charSize << 1) | (bold ? 1u : 0u);
+    }
+}
+
+void GlyphCache::prewarm(const sf::Font& font, const Range& range)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& glyphs = residentGlyphs[&font];
+    for (auto c = range.first; c <= range.last; ++c)
+    {
+        if (glyphs.insert(key(c, range.charSize, range.bold)).second)
+        {
+            font.getGlyph(c, range.charSize, range.bold);
+            prewarmedCount++;
+        }
+    }
+}
+
+bool GlyphCache::touch(const sf::Font& font, sf::Uint32 codePoint, sf::Uint32 charSize, bool bold)
+{
+    //whitespace is never rasterised
+    if (codePoint == '\n' || codePoint == '\t') return true;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (residentGlyphs[&font].insert(key(codePoint, charSize, bold)).second)
+    {
+        std::string description = "'" + std::string(1, static_cast<char>(codePoint < 128u ? codePoint : '?'))
+            + "' (" + std::to_string(codePoint) + ") size " + std::to_string(charSize) + (bold ? " bold" : "");
+        std::cerr << "Glyph Cache: uploaded " << description << std::endl;
+        uploads.push_back(description);
+        return false;
+    }
+    return true;
+}
+
+void GlyphCache::touch(const sf::Font& font, const std::string& string, sf::Uint32 charSize, bool bold)
+{
+    for (auto c : string)
+        touch(font, static_cast<sf::Uint8>(c), charSize, bold);
+}
+
+std::vector<std::string> GlyphCache::getUploads()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return uploads;
+}
+
+sf::Uint32 GlyphCache::getPrewarmedCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return prewarmedCount;
+}
@@ -0,0 +1,209 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <JobSystem.hpp>
+#include <Profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+JobSystem::JobSystem(sf::Uint32 workerCount)
+    : m_queuedCount (0u),
+    m_quit          (false),
+    m_jobsRun       (0u),
+    m_jobsStolen    (0u),
+    m_parallelFors  (0u)
+{
+    if (workerCount == 0)
+    {
+        workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1u;
+    }
+
+    //all queues exist before any worker starts looking in them
+    for (auto i = 0u; i <= workerCount; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_threads.reserve(workerCount);
+    for (auto i = 0u; i < workerCount; ++i)
+        m_threads.emplace_back(&JobSystem::work, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_quit = true;
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& t : m_threads)
+        t.join();
+}
+
+//public
+void JobSystem::run(const Job& job, Counter& counter)
+{
+    counter.m_count++;
+    m_queuedCount++;
+
+    auto& queue = *m_queues[getQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({ job, &counter });
+    }
+
+    //taking the lock makes sure a worker can't miss the notification
+    //between checking for jobs and going to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+void JobSystem::wait(Counter& counter)
+{
+    const auto queueIndex = getQueueIndex();
+    while (!counter.done())
+    {
+        if (!runJob(queueIndex))
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t)>& task)
+{
+    if (count == 0) return;
+    grainSize = std::max(std::size_t(1u), grainSize);
+    m_parallelFors++;
+
+    //not worth queuing
+    if (count <= grainSize)
+    {
+        for (auto i = 0u; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    Counter counter;
+    for (std::size_t start = 0u; start < count; start += grainSize)
+    {
+        const std::size_t end = std::min(count, start + grainSize);
+        run([&task, start, end]()
+        {
+            for (auto i = start; i < end; ++i)
+                task(i);
+        }, counter);
+    }
+    wait(counter);
+}
+
+sf::Uint32 JobSystem::getWorkerCount() const
+{
+    return m_threads.size();
+}
+
+JobSystem::FrameStats JobSystem::endFrame()
+{
+    m_lastFrameStats.jobsRun = m_jobsRun.exchange(0u);
+    m_lastFrameStats.jobsStolen = m_jobsStolen.exchange(0u);
+    m_lastFrameStats.parallelFors = m_parallelFors.exchange(0u);
+    return m_lastFrameStats;
+}
+
+const JobSystem::FrameStats& JobSystem::getLastFrameStats() const
+{
+    return m_lastFrameStats;
+}
+
+//private
+std::size_t JobSystem::getQueueIndex() const
+{
+    const auto id = std::this_thread::get_id();
+    for (auto i = 0u; i < m_threads.size(); ++i)
+    {
+        if (m_threads[i].get_id() == id) return i;
+    }
+    return m_threads.size();
+}
+
+bool JobSystem::runJob(std::size_t queueIndex)
+{
+    Task task;
+    bool found = false;
+    bool stolen = false;
+
+    //newest first from our own queue as its data is most likely still cached
+    {
+        auto& queue = *m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    //else steal the oldest job from someone else
+    for (auto i = 1u; i < m_queues.size() && !found; ++i)
+    {
+        auto& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            found = stolen = true;
+        }
+    }
+
+    if (!found) return false;
+
+    m_queuedCount--;
+    task.job();
+
+    m_jobsRun++;
+    if (stolen) m_jobsStolen++;
+
+    assert(task.counter->m_count > 0);
+    task.counter->m_count--;
+    return true;
+}
+
+void JobSystem::work(std::size_t queueIndex)
+{
+    PROFILE_THREAD_NAME("worker " + std::to_string(queueIndex));
+
+    while (true)
+    {
+        if (runJob(queueIndex)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this](){ return m_quit || m_queuedCount > 0; });
+        if (m_quit) return;
+    }
+}
\ No newline at end of file
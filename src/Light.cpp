@@ -28,6 +28,8 @@ source distribution.
 #include <Light.hpp>
 #include <Node.hpp>
 
+#include <SFML/Graphics/Shader.hpp>
+
 #include <cassert>
 
 Light::Light()
@@ -143,4 +145,19 @@ void Light::onNotify(Subject& s, const Event& e)
         }
     }
 }
+
+void LightUniforms::apply(sf::Shader& shader) const
+{
+    shader.setParameter("u_directionalLightDirection", sunDirection);
+    shader.setParameter("u_directionalLightColour", sunColour);
+    shader.setParameter("u_ambientColour", ambientColour);
+
+    shader.setParameter("u_pointLightPositionsFirst", positionsFirst);
+    shader.setParameter("u_pointLightPositionsSecond", positionsSecond);
+    shader.setParameter("u_pointLightColoursFirst", coloursFirst);
+    shader.setParameter("u_pointLightColoursSecond", coloursSecond);
+    shader.setParameter("u_inverseRangesFirst", inverseRangesFirst);
+    shader.setParameter("u_inverseRangesSecond", inverseRangesSecond);
+}
+
 //private
\ No newline at end of file
@@ -33,6 +33,8 @@ source distribution.
 
 #include <cassert>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 
 #include <iostream>
 
@@ -209,6 +211,24 @@ const std::vector<Map::Node>& Map::getNodes() const
     return m_nodes;
 }
 
+sf::FloatRect Map::getBounds() const
+{
+    sf::Vector2f min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    sf::Vector2f max(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (const auto& n : m_nodes)
+    {
+        if (n.type != Category::Solid && n.type != Category::Water) continue;
+
+        min.x = std::min(min.x, n.position.x);
+        min.y = std::min(min.y, n.position.y);
+        max.x = std::max(max.x, n.position.x + n.size.x);
+        max.y = std::max(max.y, n.position.y + n.size.y);
+    }
+
+    if (min.x > max.x) return{};
+    return{ min, max - min };
+}
+
 const sf::Vector2f& Map::getPlayerOneSpawn() const
 {
     return m_playerOneSpawn;
@@ -29,6 +29,9 @@ source distribution.
 #include <Map.hpp>
 #include <Node.hpp>
 #include <Util.hpp>
+#include <AtlasPacker.hpp>
+#include <JobSystem.hpp>
+#include <Profiler.hpp>
 
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -36,6 +39,7 @@ source distribution.
 
 #include <map>
 #include <algorithm>
+#include <iostream>
 
 namespace
 {
@@ -46,14 +50,18 @@ namespace
 
     const sf::Uint8 blockTextureCount = 4u;
     sf::Vector2f blockTextureSize;
+
+    const sf::Uint32 maxAtlasSize = 4096u;
+    const std::string atlasName; //empty so packed layers are drawn first
 }
 
-MapController::MapController(CommandStack& cs, TextureResource& tr, ShaderResource& sr)
+MapController::MapController(CommandStack& cs, TextureResource& tr, ShaderResource& sr, JobSystem& jobSystem)
     : m_commandStack    (cs),
     m_itemTime          (spawnGapTime),
     m_itemActive        (false),
     m_textureResource   (tr),
     m_shaderResource    (sr),
+    m_jobSystem         (jobSystem),
     m_itemSprite        ("res/textures/map/item.cra", tr),
     m_hatSprite         (tr.get("res/textures/map/hat_diffuse.png")),
     m_batSprite         ("res/textures/characters/bat.cra", tr),
@@ -72,7 +80,7 @@ MapController::MapController(CommandStack& cs, TextureResource& tr, ShaderResour
         m_blockSprites.emplace_back(tr.get("res/textures/map/steel_crate_diffuse.png"));
         auto& blockSprite = m_blockSprites.back();
         blockSprite.setFrameCount(1u);
-        blockSprite.setNormalMap(tr.get("res/textures/map/steel_crate_normal.tga"));
+        blockSprite.setNormalMap(tr.getHandle("res/textures/map/steel_crate_normal.tga"));
         blockSprite.setShader(sr.get(Shader::Type::NormalMap));
         blockSprite.setFrameCount(blockTextureCount);
         blockSprite.setFrameSize(sf::Vector2i(blockTextureSize));
@@ -84,7 +92,7 @@ MapController::MapController(CommandStack& cs, TextureResource& tr, ShaderResour
     m_itemSprite.play();
 
     m_hatSprite.setFrameSize(sf::Vector2i(m_hatSprite.getTexture()->getSize()));
-    m_hatSprite.setNormalMap(tr.get("res/textures/map/hat_normal.png"));
+    m_hatSprite.setNormalMap(tr.getHandle("res/textures/map/hat_normal.png"));
     m_hatSprite.setShader(sr.get(Shader::Type::Metal));
 
     m_batSprite.setShader(sr.get(Shader::Type::FlatShaded));
@@ -97,6 +105,32 @@ MapController::MapController(CommandStack& cs, TextureResource& tr, ShaderResour
 }
 
 //public
+void MapController::listAssets(const Map& map, AssetLoader::Manifest& manifest)
+{
+    const std::string path = "res/textures/map/";
+    manifest.textures.push_back(path + "item.png");
+    manifest.textures.push_back(path + "item_normal.png");
+    manifest.textures.push_back(path + "hat_diffuse.png");
+    manifest.textures.push_back(path + "hat_normal.png");
+    manifest.textures.push_back(path + "steel_crate_diffuse.png");
+    manifest.textures.push_back(path + "steel_crate_normal.tga");
+    manifest.textures.push_back(path + "water_normal.png");
+
+    //map specific textures and their normal maps
+    for (auto name : { map.getBackgroundImageName(), map.getPlatformImageName() })
+    {
+        if (name.empty()) continue;
+        manifest.textures.push_back(path + name);
+
+        auto strpos = name.find_last_of('.');
+        if (strpos != std::string::npos)
+        {
+            name.insert(strpos, "_normal");
+            manifest.textures.push_back(path + name);
+        }
+    }
+}
+
 void MapController::update(float dt)
 {
     m_itemTime -= dt;
@@ -195,14 +229,6 @@ void MapController::update(float dt)
     };
     m_commandStack.push(birdCmd);
 
-    //update animations
-    m_itemSprite.update(dt);
-    m_batSprite.update(dt);
-    m_birdSprite.update(dt);
-
-    for (auto& w : m_waterDrawables)
-        w.update(dt);
-
     //check for new hattage
     if (hatSpawnTime > 0)
     {
@@ -214,6 +240,16 @@ void MapController::update(float dt)
     }
 }
 
+void MapController::updateDrawables(float dt)
+{
+    //update animations
+    m_itemSprite.update(dt);
+    m_batSprite.update(dt);
+    m_birdSprite.update(dt);
+
+    WaterDrawable::update(m_waterDrawables, dt, m_jobSystem);
+}
+
 void MapController::setSpawnFunction(std::function<void(const Map::Node&)>& func)
 {
     spawn = func;
@@ -272,12 +308,12 @@ void MapController::loadMap(const Map& map)
 
     //load background texture based on map data
     std::string imageName = map.getBackgroundImageName();
-    m_backgroundSprite.setTexture(m_textureResource.get("res/textures/map/" + imageName));
+    m_backgroundSprite.setTexture(m_textureResource.getHandle("res/textures/map/" + imageName));
     m_backgroundSprite.setFrameSize(sf::Vector2i(m_backgroundSprite.getTexture()->getSize()));
     auto strpos = imageName.find_last_of('.');
     if(strpos != std::string::npos)
         imageName.insert(strpos, "_normal");
-    m_backgroundSprite.setNormalMap(m_textureResource.get("res/textures/map/" + imageName));
+    m_backgroundSprite.setNormalMap(m_textureResource.getHandle("res/textures/map/" + imageName));
     m_backgroundSprite.setShader(m_shaderResource.get(Shader::Type::NormalMap));
     m_shaderResource.get(Shader::Type::Water).setParameter("u_reflectMap", *m_backgroundSprite.getTexture());
     m_shaderResource.get(Shader::Type::WaterDrop).setParameter("u_reflectMap", *m_backgroundSprite.getTexture());
@@ -287,6 +323,8 @@ void MapController::loadMap(const Map& map)
     //Shader::UniformBinding::Ptr fb = std::make_unique<Shader::FunctionBinding<const sf::Texture&>>(m_shaderResource.get(Shader::Type::Metal), "u_reflectMap", f);
     //m_shaderResource.addBinding(fb);
 
+    m_rearDrawable.packAtlas(m_jobSystem);
+    m_frontDrawable.packAtlas(m_jobSystem);
     m_solidDrawable.buildShadow(m_shaderResource.get(Shader::Type::GaussianBlur));
 
     //generate some random hat spawns
@@ -319,7 +357,7 @@ sf::Drawable* MapController::getDrawable(MapController::MapDrawable type)
     case MapDrawable::Block: //TODO random different textures?
         return static_cast<sf::Drawable*>(&m_blockSprites[Util::Random::value(0, blockTextureCount - 1)]);
     case MapDrawable::Water:
-        m_waterDrawables.emplace_back(m_textureResource.get("res/textures/map/water_normal.png"), m_shaderResource.get(Shader::Type::Water));
+        m_waterDrawables.emplace_back(m_textureResource.getHandle("res/textures/map/water_normal.png"), m_shaderResource.get(Shader::Type::Water));
         return static_cast<sf::Drawable*>(&m_waterDrawables.back());
     case MapDrawable::RearDetail:
         return static_cast<sf::Drawable*>(&m_rearDrawable);
@@ -401,14 +439,14 @@ void MapController::LayerDrawable::addPart(const sf::Vector2f& pos, const sf::Ve
         auto pair = std::make_pair(textureName, LayerData());
         
         std::string texture = textureName;
-        pair.second.diffuseTexture = m_textureResource.get("res/textures/map/" + texture);
-        pair.second.diffuseTexture.setRepeated(true);
+        pair.second.diffuseTexture = m_textureResource.getHandle("res/textures/map/" + texture);
+        pair.second.diffuseTexture->setRepeated(true);
         auto strpos = texture.find_last_of('.');
         if (strpos != std::string::npos)
             texture.insert(strpos, "_normal");
 
-        pair.second.normalTexture = m_textureResource.get("res/textures/map/" + texture);
-        pair.second.normalTexture.setRepeated(true); 
+        pair.second.normalTexture = m_textureResource.getHandle("res/textures/map/" + texture);
+        pair.second.normalTexture->setRepeated(true);
         pair.second.vertexArray.setPrimitiveType(sf::Quads);
 
         m_layerData.insert(pair);
@@ -430,10 +468,11 @@ void MapController::LayerDrawable::addSprite(const std::string& textureName, con
     {
         auto pair = std::make_pair(textureName, LayerData());
 
-        pair.second.diffuseTexture = m_textureResource.get("res/textures/atlases/" + textureName);
+        pair.second.diffusePath = "res/textures/atlases/" + textureName;
         std::string normalName = textureName;
         normalName.insert(normalName.find(".png"), "_normal");
-        pair.second.normalTexture = m_textureResource.get("res/textures/atlases/" + normalName);
+        pair.second.normalPath = "res/textures/atlases/" + normalName;
+        pair.second.packable = true;
         pair.second.vertexArray.setPrimitiveType(sf::Quads);
 
         m_layerData.insert(pair);
@@ -445,6 +484,135 @@ void MapController::LayerDrawable::addSprite(const std::string& textureName, con
     }
 }
 
+void MapController::LayerDrawable::packAtlas(JobSystem& jobSystem)
+{
+    PROFILE_SCOPE("MapController::packAtlas");
+
+    struct Source
+    {
+        std::string name;
+        sf::Image diffuse;
+        sf::Image normal;
+        sf::Vector2u position;
+    };
+    std::vector<Source> sources;
+
+    auto loadSeparate = [this](LayerData& ld)
+    {
+        ld.diffuseTexture = m_textureResource.getHandle(ld.diffusePath);
+        ld.normalTexture = m_textureResource.getHandle(ld.normalPath);
+        ld.packable = false;
+    };
+
+    //tiled textures rely on repeating so can't be packed
+    for (const auto& l : m_layerData)
+    {
+        if (!l.second.packable) continue;
+        sources.emplace_back();
+        sources.back().name = l.first;
+    }
+
+    //sheets are only needed in system memory so can be decoded in parallel
+    std::vector<const LayerData*> layers;
+    for (const auto& source : sources)
+        layers.push_back(&m_layerData[source.name]);
+
+    std::vector<sf::Uint8> decoded(sources.size(), 0u);
+    jobSystem.parallelFor(sources.size(), 1u, [&sources, &layers, &decoded](std::size_t i)
+    {
+        decoded[i] = (sources[i].diffuse.loadFromFile(layers[i]->diffusePath)
+            && sources[i].normal.loadFromFile(layers[i]->normalPath)
+            && sources[i].diffuse.getSize() == sources[i].normal.getSize());
+    });
+
+    std::vector<Source> loaded;
+    for (auto i = 0u; i < sources.size(); ++i)
+    {
+        if (decoded[i])
+        {
+            loaded.push_back(std::move(sources[i]));
+        }
+        else
+        {
+            std::cerr << "Atlas Packer: " << sources[i].name << " missing or mismatched normal map, not packed." << std::endl;
+            loadSeparate(m_layerData[sources[i].name]);
+        }
+    }
+    sources.swap(loaded);
+
+    //no point making an atlas from a single texture
+    if (sources.size() < 2)
+    {
+        for (const auto& s : sources) loadSeparate(m_layerData[s.name]);
+        return;
+    }
+
+    //tallest first packs more tightly
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+    {
+        return a.diffuse.getSize().y > b.diffuse.getSize().y;
+    });
+
+    const sf::Uint32 atlasSize = std::min(sf::Texture::getMaximumSize(), maxAtlasSize);
+    AtlasPacker packer({ atlasSize, atlasSize });
+    std::vector<const Source*> packed;
+    for (auto& s : sources)
+    {
+        if (packer.insert(s.diffuse.getSize(), s.position))
+        {
+            packed.push_back(&s);
+        }
+        else
+        {
+            loadSeparate(m_layerData[s.name]);
+        }
+    }
+
+    if (packed.size() < 2)
+    {
+        for (const auto s : packed) loadSeparate(m_layerData[s->name]);
+        return;
+    }
+
+    const auto& size = packer.getUsedSize();
+    sf::Image diffuseImage;
+    diffuseImage.create(size.x, size.y, sf::Color::Transparent);
+    sf::Image normalImage;
+    normalImage.create(size.x, size.y, sf::Color(127u, 127u, 255u));
+
+    //keep the original sheet order so overlapping sprites are drawn as before
+    std::sort(packed.begin(), packed.end(), [](const Source* a, const Source* b)
+    {
+        return a->name < b->name;
+    });
+
+    LayerData atlas;
+    atlas.vertexArray.setPrimitiveType(sf::Quads);
+    for (const auto s : packed)
+    {
+        diffuseImage.copy(s->diffuse, s->position.x, s->position.y);
+        normalImage.copy(s->normal, s->position.x, s->position.y);
+
+        //sprite sheet tex coords are in pixels so only need offsetting
+        const sf::Vector2f offset(s->position);
+        const auto& vertexArray = m_layerData[s->name].vertexArray;
+        for (auto i = 0u; i < vertexArray.getVertexCount(); ++i)
+        {
+            auto vertex = vertexArray[i];
+            vertex.texCoords += offset;
+            atlas.vertexArray.append(vertex);
+        }
+        m_layerData.erase(s->name);
+    }
+    //atlases are unique to this layer so aren't stored in the texture resource
+    atlas.diffuseTexture = Resource::Handle<sf::Texture>(std::make_shared<sf::Texture>());
+    atlas.diffuseTexture->loadFromImage(diffuseImage);
+    atlas.normalTexture = Resource::Handle<sf::Texture>(std::make_shared<sf::Texture>());
+    atlas.normalTexture->loadFromImage(normalImage);
+
+    m_layerData.insert(std::make_pair(atlasName, atlas));
+}
+
 void MapController::LayerDrawable::buildShadow(sf::Shader& blurShader)
 {
     const sf::Vector2i texSize(480, 270); //TODO link magic numbers to view size
@@ -498,9 +666,9 @@ void MapController::LayerDrawable::draw(sf::RenderTarget& rt, sf::RenderStates s
     for (const auto& layer : m_layerData)
     {
         m_shader.setParameter("u_diffuseMap", sf::Shader::CurrentTexture);
-        m_shader.setParameter("u_normalMap", layer.second.normalTexture);
+        m_shader.setParameter("u_normalMap", *layer.second.normalTexture);
         m_shader.setParameter("u_xNormMultiplier", 1.f);
-        states.texture = &layer.second.diffuseTexture;
+        states.texture = layer.second.diffuseTexture.get();
         rt.draw(layer.second.vertexArray, states);
     }
 }
\ No newline at end of file
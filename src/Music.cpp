@@ -38,11 +38,13 @@ MusicPlayer::MusicPlayer()
 
 void MusicPlayer::play(const std::string& title, bool loop)
 {
-    if (m_music.openFromFile(title))
+    if (!m_music) m_music = std::make_unique<sf::Music>();
+
+    if (m_music->openFromFile(title))
     {
-        m_music.setVolume(m_volume);
-        m_music.setLoop(loop);
-        m_music.play();
+        m_music->setVolume(m_volume);
+        m_music->setLoop(loop);
+        m_music->play();
     }
     else
     {
@@ -53,12 +55,13 @@ void MusicPlayer::play(const std::string& title, bool loop)
 
 void MusicPlayer::stop()
 {
-    m_music.stop();
+    if (m_music) m_music->stop();
 }
 
 void MusicPlayer::setPaused(bool paused)
 {
-    (paused) ? m_music.pause() : m_music.play();
+    if (!m_music) return;
+    (paused) ? m_music->pause() : m_music->play();
 }
 
 void MusicPlayer::setVolume(float volume)
@@ -66,8 +69,8 @@ void MusicPlayer::setVolume(float volume)
     assert(volume >= 0.f && volume <= 100.f);
 
     m_volume = volume;
-    if(m_music.getStatus() == sf::Music::Playing)
-        m_music.setVolume(volume);
+    if(m_music && m_music->getStatus() == sf::Music::Playing)
+        m_music->setVolume(volume);
 }
 
 float MusicPlayer::getVolume() const
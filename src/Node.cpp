@@ -24,26 +24,29 @@ and must not be misrepresented as being the original software.
 3. This notice may not be removed or altered from any
 source distribution.
 *********************************************************************/
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include <Node.hpp>
 #include <Scene.hpp>
 #include <WaterDrawable.hpp>
 #include <Util.hpp>
 #include <Light.hpp>
+#include <RenderSnapshot.hpp>
 
 #include <cassert>
 #include <iostream>
+#include <cmath>
 
 Node::Node(const std::string& name)
-    : m_parent      (nullptr),
-    m_name          (name),
-    m_scene         (nullptr),
-    m_camera        (nullptr),
-    m_drawable      (nullptr),
-    m_collisionBody (nullptr),
-    m_category      (Category::None),
-    m_blendMode     (sf::BlendAlpha)
+    : m_parent              (nullptr),
+    m_name                  (name),
+    m_scene                 (nullptr),
+    m_camera                (nullptr),
+    m_drawable              (nullptr),
+    m_collisionBody         (nullptr),
+    m_category              (Category::None),
+    m_blendMode             (sf::BlendAlpha),
+    m_previousRotation      (0.f),
+    m_previousScale         (1.f, 1.f),
+    m_hasPreviousTransform  (false)
 {
 
 }
@@ -412,25 +415,55 @@ void Node::raiseEvent(const Event& evt)
     notify(*this, evt);
 }
 
-//private
-void Node::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+void Node::storeTransform()
 {
-    states.transform *= getTransform();
-    drawSelf(rt, states);
-    drawChildren(rt, states);
+    m_previousPosition = getPosition();
+    m_previousRotation = getRotation();
+    m_previousScale = getScale();
+    m_hasPreviousTransform = true;
+
+    for (auto& c : m_children)
+        c->storeTransform();
 }
 
-void Node::drawSelf(sf::RenderTarget& rt, sf::RenderStates states) const
+void Node::snapshot(RenderSnapshot& snapshot, sf::Transform previous, sf::Transform current) const
 {
+    previous *= getPreviousTransform();
+    current *= getTransform();
+
     if (m_drawable)
-    {
-        states.blendMode = m_blendMode;
-        rt.draw(*m_drawable, states);
-    }
+        snapshot.addDrawable(*m_drawable, previous, current, m_blendMode);
+
+    for (const auto& c : m_children)
+        c->snapshot(snapshot, previous, current);
 }
 
-void Node::drawChildren(sf::RenderTarget& rt, sf::RenderStates states) const
+//private
+//the transform stored at the start of the tick, or the current
+//transform if there isn't one or the node has since been teleported
+sf::Transform Node::getPreviousTransform() const
 {
-    for (const auto& c : m_children)
-        c->draw(rt, states);
+    if (!m_hasPreviousTransform) return getTransform();
+
+    //anything which moved further than this in one tick was teleported
+    //(ie respawned) so should not be drawn sweeping across the screen
+    const float maxDistance = 200.f;
+    const auto distance = getPosition() - m_previousPosition;
+    if (std::fabs(distance.x) > maxDistance || std::fabs(distance.y) > maxDistance) return getTransform();
+
+    //same as sf::Transformable::getTransform()
+    const auto& origin = getOrigin();
+    const float angle = -m_previousRotation * 3.141592654f / 180.f;
+    const float cosine = std::cos(angle);
+    const float sine = std::sin(angle);
+    const float sxc = m_previousScale.x * cosine;
+    const float syc = m_previousScale.y * cosine;
+    const float sxs = m_previousScale.x * sine;
+    const float sys = m_previousScale.y * sine;
+    const float tx = -origin.x * sxc - origin.y * sys + m_previousPosition.x;
+    const float ty = origin.x * sxs - origin.y * syc + m_previousPosition.y;
+
+    return sf::Transform(sxc, sys, tx,
+                        -sxs, syc, ty,
+                        0.f, 0.f, 1.f);
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <OccupancyGrid.hpp>
+#include <WaterDrawable.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+OccupancyGrid::OccupancyGrid(const sf::FloatRect& worldBounds, float cellSize)
+    : m_bounds          (worldBounds),
+    m_cellSize          (cellSize),
+    m_inverseCellSize   (1.f / cellSize),
+    m_width             (static_cast<sf::Uint32>(std::ceil(worldBounds.width / cellSize))),
+    m_height            (static_cast<sf::Uint32>(std::ceil(worldBounds.height / cellSize)))
+{
+    assert(cellSize > 0.f);
+    m_cells.resize(m_width * m_height, Empty);
+}
+
+//public
+void OccupancyGrid::addSolid(const sf::FloatRect& area)
+{
+    fill(area, Solid);
+}
+
+void OccupancyGrid::addWater(const sf::FloatRect& area, WaterDrawable& drawable)
+{
+    fill(area, Water);
+    m_waterBodies.push_back({ area, &drawable });
+}
+
+void OccupancyGrid::clear()
+{
+    std::fill(m_cells.begin(), m_cells.end(), Empty);
+    m_waterBodies.clear();
+}
+
+void OccupancyGrid::resize(const sf::FloatRect& worldBounds)
+{
+    m_bounds = worldBounds;
+    m_width = static_cast<sf::Uint32>(std::ceil(worldBounds.width * m_inverseCellSize));
+    m_height = static_cast<sf::Uint32>(std::ceil(worldBounds.height * m_inverseCellSize));
+    m_cells.assign(m_width * m_height, Empty);
+    m_waterBodies.clear();
+}
+
+OccupancyGrid::Cell OccupancyGrid::getCell(float x, float y) const
+{
+    //range is checked before converting, as out of range values (or NaN
+    //from a runaway particle) can't be converted. written so NaN fails
+    const float gridX = (x - m_bounds.left) * m_inverseCellSize;
+    const float gridY = (y - m_bounds.top) * m_inverseCellSize;
+    if (!(gridX >= 0.f && gridX < m_width && gridY >= 0.f && gridY < m_height)) return Empty;
+
+    //non-negative, so truncating is the same as floor
+    const auto cellX = static_cast<sf::Uint32>(gridX);
+    const auto cellY = static_cast<sf::Uint32>(gridY);
+
+    return static_cast<Cell>(m_cells[cellY * m_width + cellX]);
+}
+
+void OccupancyGrid::splash(float x, float y, float speed)
+{
+    //there are only ever a handful of water bodies
+    for (const auto& wb : m_waterBodies)
+    {
+        //cells are coarser than the water area so clamp to its surface
+        const float left = x - wb.area.left;
+        if (left >= 0.f && left < wb.area.width
+            && y >= wb.area.top - m_cellSize && y < wb.area.top + wb.area.height)
+        {
+            wb.drawable->splash(left, speed);
+            return;
+        }
+    }
+}
+
+//private
+void OccupancyGrid::fill(const sf::FloatRect& area, Cell cell)
+{
+    auto clampX = [this](float v)
+    {
+        return static_cast<sf::Uint32>(std::max(0.f, std::min(static_cast<float>(m_width), v)));
+    };
+    auto clampY = [this](float v)
+    {
+        return static_cast<sf::Uint32>(std::max(0.f, std::min(static_cast<float>(m_height), v)));
+    };
+
+    const auto startX = clampX(std::floor((area.left - m_bounds.left) * m_inverseCellSize));
+    const auto endX = clampX(std::ceil((area.left + area.width - m_bounds.left) * m_inverseCellSize));
+    const auto startY = clampY(std::floor((area.top - m_bounds.top) * m_inverseCellSize));
+    const auto endY = clampY(std::ceil((area.top + area.height - m_bounds.top) * m_inverseCellSize));
+
+    for (auto y = startY; y < endY; ++y)
+    {
+        for (auto x = startX; x < endX; ++x)
+        {
+            //solid takes priority where areas overlap
+            auto& c = m_cells[y * m_width + x];
+            if (c != Solid) c = cell;
+        }
+    }
+}
@@ -28,14 +28,32 @@ source distribution.
 #include <ParticleController.hpp>
 #include <ParticleShaders.hpp>
 #include <Node.hpp>
+#include <RenderSnapshot.hpp>
+#include <JobSystem.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
 
 #include <iostream>
+#include <algorithm>
 
 namespace
 {
+    //hard limit on live particles across all systems. above the
+    //soft limit bursts release half as many particles
+    const sf::Uint32 maxParticles = 8000u;
+    const sf::Uint32 softMaxParticles = maxParticles * 3u / 4u;
+
+    const sf::FloatRect worldBounds(0.f, 0.f, 1920.f, 1080.f);
+    const float collisionCellSize = 10.f;
+
+    bool cosmetic(Particle::Type type)
+    {
+        return (type == Particle::Type::Sparkle
+            || type == Particle::Type::Smoke
+            || type == Particle::Type::Puff);
+    }
+
     //actually looks better to pick one of these at random
     //rather than trying to get random floats in such a large range
     std::vector<sf::Vector2f> splatVelocities =
@@ -111,18 +129,66 @@ namespace
     };
 }
 
-ParticleController::ParticleController(TextureResource& tr, ShaderResource& sr)
-    : m_textureResource (tr),
-    m_shaderResource    (sr)
+ParticleController::ParticleController(TextureResource& tr, ShaderResource& sr, JobSystem& jobSystem)
+    : m_liveParticleCount   (0u),
+    m_jobSystem             (jobSystem),
+    m_collisionGrid         (worldBounds, collisionCellSize)
 {
     m_systems.reserve(50);
+
+    auto setResources = [&](Particle::Type type, const std::string& texture, const std::string& normalMap, Shader::Type shader)
+    {
+        auto& res = m_systemResources[type];
+        res.texture = &tr.get(texture);
+        if (!normalMap.empty()) res.normalMap = &tr.get(normalMap);
+        res.shader = &sr.get(shader);
+    };
+    setResources(Particle::Type::Splat, "res/textures/particles/gear.png", "res/textures/particles/gear_normal.png", Shader::Type::Metal);
+    setResources(Particle::Type::Splash, "res/textures/particles/water_splash.png", "res/textures/particles/water_splash_normal.png", Shader::Type::WaterDrop);
+    setResources(Particle::Type::Puff, "res/textures/particles/dust_puff.png", "", Shader::Type::FlatShaded);
+    setResources(Particle::Type::PlayerOneDie, "res/textures/particles/player_one_particle.png", "", Shader::Type::FlatShaded);
+    setResources(Particle::Type::PlayerTwoDie, "res/textures/particles/player_two_particle.png", "", Shader::Type::FlatShaded);
+    setResources(Particle::Type::Smoke, "res/textures/particles/dust_puff.png", "", Shader::Type::FlatShaded);
+    setResources(Particle::Type::Sparkle, "res/textures/particles/sparkle.png", "", Shader::Type::FlatShaded);
 }
 
 //public
 void ParticleController::update(float dt)
 {
+    //emitters follow nodes so are updated here first. the budget is
+    //enforced as particles are emitted, as emitters started without a
+    //duration keep emitting long after startSystem() checked the count
     for (auto& p : m_systems)
-        p.update(dt);
+    {
+        const auto allowance = (m_liveParticleCount < maxParticles) ? maxParticles - m_liveParticleCount : 0u;
+        m_liveParticleCount += p->updateEmitter(dt, allowance);
+    }
+
+    //then each system simulates and builds its vertices as a job
+    m_jobSystem.parallelFor(m_systems.size(), 1u, [this, dt](std::size_t i)
+    {
+        m_systems[i]->updateParticles(dt);
+    });
+
+    //water drawables are shared so splashes are applied here on one thread
+    for (const auto& p : m_systems)
+    {
+        for (const auto& hit : p->getWaterHits())
+            m_collisionGrid.splash(hit.x, hit.y, std::min(200.f, hit.speed));
+    }
+
+    //return stopped emitters to the free lists
+    m_activeSystems.erase(std::remove_if(m_activeSystems.begin(), m_activeSystems.end(),
+        [this](ParticleSystem* ps)
+    {
+        if (ps->started()) return false;
+        m_idleSystems[ps->getType()].push_back(ps);
+        return true;
+    }), m_activeSystems.end());
+
+    m_liveParticleCount = 0u;
+    for (const auto& p : m_systems)
+        m_liveParticleCount += p->getParticleCount();
 }
 
 void ParticleController::onNotify(Subject& s, const Event& evt)
@@ -139,28 +205,28 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
             {
                 auto& ps = findSystem(Particle::Type::Splat);
                 ps.setPosition({ evt.node.positionX, evt.node.positionY });
-                ps.start(6u, 0.1f);
+                startSystem(ps, 6u, 0.1f);
             }
                 break;
             case Category::PlayerOne:
             {
                 auto& ps = findSystem(Particle::Type::PlayerOneDie);
                 ps.setPosition({ evt.node.positionX, evt.node.positionY });
-                ps.start(1u, 0.1f);
+                startSystem(ps, 1u, 0.1f);
             }
                 break;
             case Category::PlayerTwo:
             {
                 auto& ps = findSystem(Particle::Type::PlayerTwoDie);
                 ps.setPosition({ evt.node.positionX, evt.node.positionY });
-                ps.start(1u, 0.1f);
+                startSystem(ps, 1u, 0.1f);
             }
                 break;
             default:
             {
                 auto& ps = findSystem(Particle::Type::Puff);
                 ps.setPosition({ evt.node.positionX, evt.node.positionY });
-                ps.start(5u, 0.02f);
+                startSystem(ps, 5u, 0.02f);
             }
                 break;
             }
@@ -172,7 +238,7 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
             //splish!
             auto& ps = findSystem(Particle::Type::Splash);
             ps.setPosition({ evt.node.positionX, evt.node.positionY });
-            ps.start(4u, 0.02f);
+            startSystem(ps, 4u, 0.02f);
         }
         break;
         case Event::NodeEvent::Spawn:
@@ -182,7 +248,7 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
                 //do dust puff
                 auto& ps = findSystem(Particle::Type::Puff);
                 ps.setPosition({ evt.node.positionX, evt.node.positionY });
-                ps.start(5u, 0.1f);
+                startSystem(ps, 5u, 0.1f);
             }
         }
         break;
@@ -191,7 +257,7 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
         {
             /*auto& ps = findSystem(Particle::Type::Smoke);
             ps.setNode(static_cast<Node&>(s));
-            ps.start();*/
+            startSystem(ps);*/
         }
             break;
         /*case Event::NodeEvent::LeftTurbo:
@@ -208,7 +274,7 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
         {
             auto& ps = findSystem(Particle::Type::Sparkle);
             ps.setNode(static_cast<Node&>(s));
-            ps.start();
+            startSystem(ps);
         }
             break;
         default: break;
@@ -216,126 +282,129 @@ void ParticleController::onNotify(Subject& s, const Event& evt)
     }
 }
 
+OccupancyGrid& ParticleController::getCollisionGrid()
+{
+    return m_collisionGrid;
+}
+
+sf::Uint32 ParticleController::getLiveParticleCount() const
+{
+    return m_liveParticleCount;
+}
+
+sf::Uint32 ParticleController::getEmitterCount() const
+{
+    return m_systems.size();
+}
+
+sf::Uint32 ParticleController::getActiveEmitterCount() const
+{
+    return m_activeSystems.size();
+}
+
+void ParticleController::snapshot(RenderSnapshot& snapshot) const
+{
+    for (const auto& p : m_systems)
+        if (p->getParticleCount() > 0)
+            snapshot.addParticles(*p);
+}
+
 //private
 ParticleSystem& ParticleController::addSystem(Particle::Type type)
 {
-    m_systems.emplace_back(type);
-    ParticleSystem& particleSystem = m_systems.back();
+    m_systems.emplace_back(std::make_unique<ParticleSystem>(type));
+    ParticleSystem& particleSystem = *m_systems.back();
+
+    const auto& res = m_systemResources[type];
+    if (res.texture) particleSystem.setTexture(*res.texture);
+    if (res.normalMap) particleSystem.setNormalMap(*res.normalMap);
+    if (res.shader) particleSystem.setShader(*res.shader);
+
     switch (type)
     {
     case Particle::Type::Splat:
         {
-            particleSystem.setTexture(m_textureResource.get("res/textures/particles/gear.png"));
-            particleSystem.setNormalMap(m_textureResource.get("res/textures/particles/gear_normal.png"));
             particleSystem.setRandomInitialVelocity(splatVelocities);
-            particleSystem.setShader(m_shaderResource.get(Shader::Type::Metal));
+            particleSystem.setCollisionGrid(&m_collisionGrid, ParticleSystem::CollisionMode::Bounce);
+            particleSystem.setSplashWater(true);
 
             ForceAffector fa({ 0.f, 3500.f }); //gravity
-            particleSystem.addAffector(fa);
             RotateAffector ra(380.f);
-            particleSystem.addAffector(ra);
             ScaleAffector sa({ 5.5f, 5.5f });
-            particleSystem.addAffector(sa);
+            particleSystem.setAffectorPipeline(makeAffectorPipeline(fa, ra, sa));
         }
         break;
     case  Particle::Type::Splash:
         {
-            particleSystem.setTexture(m_textureResource.get("res/textures/particles/water_splash.png"));
-            particleSystem.setNormalMap( m_textureResource.get("res/textures/particles/water_splash_normal.png"));
-            particleSystem.setShader(m_shaderResource.get(Shader::Type::WaterDrop));
             particleSystem.setColour({ 96u, 172u, 222u, 190u });
             particleSystem.setParticleLifetime(1.2f);
             particleSystem.setParticleSize({ 4.f, 9.f });
             particleSystem.setRandomInitialVelocity(splashVelocities);
+            particleSystem.setCollisionGrid(&m_collisionGrid, ParticleSystem::CollisionMode::Die);
+            particleSystem.setSplashWater(true);
 
             ForceAffector fa({ 0.f, 1500.f }); //gravity
-            particleSystem.addAffector(fa);
-
             ScaleAffector sa({ 1.f, 8.5f });
-            particleSystem.addAffector(sa);
+            particleSystem.setAffectorPipeline(makeAffectorPipeline(fa, sa));
             
             particleSystem.setBlendMode(sf::BlendAlpha);
         }
         break;
     case Particle::Type::Puff:
-        particleSystem.setTexture(m_textureResource.get("res/textures/particles/dust_puff.png"));
-        particleSystem.setShader(m_shaderResource.get(Shader::Type::FlatShaded));
         particleSystem.setParticleLifetime(1.f);
         particleSystem.setParticleSize({ 10.f, 10.f });
         particleSystem.setRandomInitialVelocity(puffVelocities);
         {
             ForceAffector fa({ 0.f, -20.f });
-            particleSystem.addAffector(fa);
-
             ScaleAffector sa({ 4.f, 2.f });
-            particleSystem.addAffector(sa);
-
             RotateAffector ra(40.f);
-            particleSystem.addAffector(ra);
+            particleSystem.setAffectorPipeline(makeAffectorPipeline(fa, sa, ra));
         }
         break;
     case Particle::Type::PlayerOneDie: //TODO p1 and p2 are rather similar....
     {
-        auto texture = m_textureResource.get("res/textures/particles/player_one_particle.png");
-        particleSystem.setTexture(m_textureResource.get("res/textures/particles/player_one_particle.png"));
-        particleSystem.setShader(m_shaderResource.get(Shader::Type::FlatShaded));
         particleSystem.setParticleLifetime(2.f);
-        particleSystem.setParticleSize(sf::Vector2f(texture.getSize()));
+        particleSystem.setParticleSize(sf::Vector2f(res.texture->getSize()));
         particleSystem.setInitialVelocity({ 12.f, -100.f });
 
         ForceAffector fa({ 0.f, 20.f });
-        particleSystem.addAffector(fa);
+        particleSystem.setAffectorPipeline(makeAffectorPipeline(fa));
     }
         break;
     case Particle::Type::PlayerTwoDie:        
     {
-        auto texture = m_textureResource.get("res/textures/particles/player_two_particle.png");
-        particleSystem.setTexture(m_textureResource.get("res/textures/particles/player_two_particle.png"));
-        particleSystem.setShader(m_shaderResource.get(Shader::Type::FlatShaded));
         particleSystem.setParticleLifetime(2.f);
-        particleSystem.setParticleSize(sf::Vector2f(texture.getSize()));
+        particleSystem.setParticleSize(sf::Vector2f(res.texture->getSize()));
         particleSystem.setInitialVelocity({ 12.f, -100.f });
 
         ForceAffector fa({ 0.f, 20.f });
-        particleSystem.addAffector(fa);
+        particleSystem.setAffectorPipeline(makeAffectorPipeline(fa));
 
     }
     break;
     case Particle::Type::Smoke:
     {
-        particleSystem.setTexture(m_textureResource.get("res/textures/particles/dust_puff.png"));
-        particleSystem.setShader(m_shaderResource.get(Shader::Type::FlatShaded));
         particleSystem.setParticleLifetime(3.f);
         particleSystem.setParticleSize({ 10.f, 10.f });
         particleSystem.setRandomInitialVelocity(smokeVelocities);
         particleSystem.setEmitRate(20.f);
         
         ForceAffector fa({ 10.f, -60.f });
-        particleSystem.addAffector(fa);
-
         ScaleAffector sa({ 10.f, 10.f });
-        particleSystem.addAffector(sa);
-
         RotateAffector ra(40.f);
-        particleSystem.addAffector(ra);
+        particleSystem.setAffectorPipeline(makeAffectorPipeline(fa, sa, ra));
         
     }
         break;
     case Particle::Type::Sparkle:
-        particleSystem.setTexture(m_textureResource.get("res/textures/particles/sparkle.png"));
-        particleSystem.setShader(m_shaderResource.get(Shader::Type::FlatShaded));
         particleSystem.setParticleLifetime(0.5f);
         particleSystem.setParticleSize({ 10.f, 10.f });
         particleSystem.setRandomInitialVelocity(sparkVelocities);
         {
             ForceAffector fa({ 0.f, 20.f });
-            particleSystem.addAffector(fa);
-
             ScaleAffector sa({ 2.f, 2.f });
-            particleSystem.addAffector(sa);
-
             RotateAffector ra(140.f);
-            particleSystem.addAffector(ra);
+            particleSystem.setAffectorPipeline(makeAffectorPipeline(fa, sa, ra));
         }
         break;
     default: break;
@@ -345,29 +414,70 @@ ParticleSystem& ParticleController::addSystem(Particle::Type type)
 
 ParticleSystem& ParticleController::findSystem(Particle::Type type)
 {
-    //find an idle system and use it
-    auto result = std::find_if(m_systems.begin(), m_systems.end(),
-        [type](const ParticleSystem& ps)
+    //reuse an idle system if there is one
+    ParticleSystem* ps = nullptr;
+    auto& idle = m_idleSystems[type];
+    if (!idle.empty())
     {
-        return (ps.getType() == type && !ps.started());
-    });
+        ps = idle.back();
+        idle.pop_back();
+    }
+    //else append a new system
+    else
+    {
+        ps = &addSystem(type);
+    }
+
+    m_activeSystems.push_back(ps);
+    return *ps;
+}
 
-    if (result != m_systems.end())
+void ParticleController::startSystem(ParticleSystem& ps, sf::Uint8 releaseCount, float duration)
+{
+    //make room by dropping the oldest cosmetic effects first
+    while (m_liveParticleCount >= maxParticles)
     {
-        return (*result); 
+        if (!cullCosmeticSystems()) return;
     }
 
-    //else append a new system
-    else
+    if (m_liveParticleCount > softMaxParticles)
+    {
+        releaseCount = std::max(sf::Uint8(1u), sf::Uint8(releaseCount / 2u));
+    }
+    ps.start(releaseCount, duration);
+}
+
+bool ParticleController::cullCosmeticSystems()
+{
+    auto cull = [this](ParticleSystem* ps)
+    {
+        if (cosmetic(ps->getType()) && ps->getParticleCount() > 0)
+        {
+            m_liveParticleCount -= ps->getParticleCount();
+            ps->clear();
+            return true;
+        }
+        return false;
+    };
+
+    //systems which have finished emitting are older than any still running
+    for (auto& idle : m_idleSystems)
+    {
+        for (auto ps : idle.second)
+            if (cull(ps)) return true;
+    }
+
+    for (auto ps : m_activeSystems)
     {
-        return addSystem(type);
+        if (cull(ps)) return true;
     }
+    return false;
 }
 
 void ParticleController::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
     //only draw visible.
     for (auto& p : m_systems) 
-        if(p.getParticleCount() > 0) 
-            rt.draw(p, states);
+        if(p->getParticleCount() > 0) 
+            rt.draw(*p, states);
 }
\ No newline at end of file
@@ -28,36 +28,78 @@ source distribution.
 #include <Particles.hpp>
 #include <Util.hpp>
 #include <Node.hpp>
+#include <OccupancyGrid.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
+#include <cmath>
+#include <limits>
+
 namespace
 {
+    const sf::Uint32 defaultCapacity = 512u;
+    const float degToRad = 3.14159265f / 180.f;
+    const float bounceRestitution = 0.4f;
+}
+
+void ParticleData::setCapacity(std::size_t capacity)
+{
+    positionX.resize(capacity);
+    positionY.resize(capacity);
+    velocityX.resize(capacity);
+    velocityY.resize(capacity);
+    scaleX.resize(capacity);
+    scaleY.resize(capacity);
+    rotation.resize(capacity);
+    lifetime.resize(capacity);
+    colour.resize(capacity);
+    count = std::min(count, capacity);
+}
+
+std::size_t ParticleData::getCapacity() const
+{
+    return lifetime.size();
+}
 
+void ParticleData::remove(std::size_t i)
+{
+    const std::size_t last = --count;
+    positionX[i] = positionX[last];
+    positionY[i] = positionY[last];
+    velocityX[i] = velocityX[last];
+    velocityY[i] = velocityY[last];
+    scaleX[i] = scaleX[last];
+    scaleY[i] = scaleY[last];
+    rotation[i] = rotation[last];
+    lifetime[i] = lifetime[last];
+    colour[i] = colour[last];
 }
 
+//-------------------------------------------
+
 ParticleSystem::ParticleSystem(Particle::Type type)
     : m_texture         (nullptr),
     m_normalMap         (nullptr),
     m_colour            (sf::Color::White),
     m_particleSize      (4.f, 4.f),
+    m_particleLifetime  (2.f),
     m_type              (type),
     m_randVelocity      (false),
     m_emitRate          (30.f),
-    m_particleLifetime  (2.f),
     m_started           (false),
     m_accumulator       (0.f),
-    m_vertices          (sf::Quads),
-    m_needsUpdate       (true),
+    m_collisionGrid     (nullptr),
+    m_collisionMode     (CollisionMode::None),
+    m_splashWater       (false),
     m_duration          (0.f),
     m_releaseCount      (1u),
     m_blendMode         (sf::BlendAdd),
     m_shader            (nullptr),
     m_parent            (nullptr)
 {
-
+    setCapacity(defaultCapacity);
 }
 
 //public
@@ -126,6 +168,28 @@ void ParticleSystem::setEmitRate(float rate)
     m_emitRate = rate;
 }
 
+void ParticleSystem::setCapacity(sf::Uint32 capacity)
+{
+    m_particles.setCapacity(capacity);
+    m_vertices.resize(capacity * 4u);
+}
+
+void ParticleSystem::setCollisionGrid(const OccupancyGrid* grid, CollisionMode mode)
+{
+    m_collisionGrid = grid;
+    m_collisionMode = mode;
+}
+
+void ParticleSystem::setSplashWater(bool splash)
+{
+    m_splashWater = splash;
+}
+
+const std::vector<ParticleSystem::WaterHit>& ParticleSystem::getWaterHits() const
+{
+    return m_waterHits;
+}
+
 void ParticleSystem::addAffector(Affector& a)
 {
     m_affectors.push_back(a);
@@ -152,26 +216,20 @@ void ParticleSystem::stop()
     m_started = false;
 }
 
-void ParticleSystem::update(float dt)
+void ParticleSystem::clear()
 {
-    //remove dead particles
-    while (!m_particles.empty() && m_particles.front().lifetime <= 0)
-    {
-        m_particles.pop_front();
-    }
-
-    for (auto& p : m_particles)
-    {
-        p.lifetime -= dt;
-        p.move(p.velocity * dt);
-        for (auto& a : m_affectors)
-        {
-            a(p, dt);
-        }
-    }
+    m_particles.count = 0u;
+}
 
-    m_needsUpdate = true;
+void ParticleSystem::update(float dt)
+{
+    updateEmitter(dt, std::numeric_limits<sf::Uint32>::max());
+    updateParticles(dt);
+}
 
+sf::Uint32 ParticleSystem::updateEmitter(float dt, sf::Uint32 allowance)
+{
+    sf::Uint32 emitted = 0u;
     if (m_started)
     {
         if (m_parent)
@@ -179,7 +237,7 @@ void ParticleSystem::update(float dt)
             m_position = m_parent->getCentre();
         }
 
-        emit(dt);
+        emitted = emit(dt, allowance);
         if (m_duration > 0)
         {
             if (m_durationClock.getElapsedTime().asSeconds() > m_duration)
@@ -188,19 +246,112 @@ void ParticleSystem::update(float dt)
             }
         }
     }
+    return emitted;
+}
+
+void ParticleSystem::updateParticles(float dt)
+{
+    auto& particles = m_particles;
+    const std::size_t count = particles.count;
+    for (auto i = 0u; i < count; ++i)
+    {
+        particles.lifetime[i] -= dt;
+        particles.positionX[i] += particles.velocityX[i] * dt;
+        particles.positionY[i] += particles.velocityY[i] * dt;
+    }
+
+    m_waterHits.clear();
+    if (m_collisionGrid) collide(dt);
+
+    if (m_pipeline) m_pipeline(particles, dt);
+
+    for (auto& a : m_affectors)
+    {
+        for (auto i = 0u; i < count; ++i)
+            a(particles, i, dt);
+    }
+
+    //remove dead particles by swapping in the last live one
+    for (auto i = 0u; i < particles.count;)
+    {
+        if (particles.lifetime[i] > 0.f) ++i;
+        else particles.remove(i);
+    }
+
+    updateVertices();
+}
+
+void ParticleSystem::collide(float dt)
+{
+    auto& particles = m_particles;
+    const auto& grid = *m_collisionGrid;
+    const std::size_t count = particles.count;
+    for (auto i = 0u; i < count; ++i)
+    {
+        const float x = particles.positionX[i];
+        const float y = particles.positionY[i];
+        const auto cell = grid.getCell(x, y);
+        if (cell == OccupancyGrid::Empty) continue;
+
+        //velocity has not yet been modified this frame so gives us the last position
+        const float lastX = x - particles.velocityX[i] * dt;
+        const float lastY = y - particles.velocityY[i] * dt;
+        const auto lastCell = grid.getCell(lastX, lastY);
+
+        if (cell == OccupancyGrid::Water)
+        {
+            //only on entry, else particles emitted in the water die immediately
+            if (lastCell != OccupancyGrid::Water)
+            {
+                if (m_splashWater)
+                    m_waterHits.push_back({ x, y, std::fabs(particles.velocityY[i]) });
+                particles.lifetime[i] = 0.f;
+            }
+            continue;
+        }
+
+        if (lastCell == OccupancyGrid::Solid) continue; //spawned inside geometry
+
+        switch (m_collisionMode)
+        {
+        case CollisionMode::Stick:
+            particles.positionX[i] = lastX;
+            particles.positionY[i] = lastY;
+            particles.velocityX[i] = 0.f;
+            particles.velocityY[i] = 0.f;
+            break;
+        case CollisionMode::Bounce:
+        {
+            //reflect on whichever axis moved us into the solid cell
+            const bool hitX = grid.getCell(x, lastY) == OccupancyGrid::Solid;
+            const bool hitY = grid.getCell(lastX, y) == OccupancyGrid::Solid;
+            if (hitX || !hitY) particles.velocityX[i] *= -bounceRestitution;
+            if (hitY || !hitX) particles.velocityY[i] *= -bounceRestitution;
+            particles.positionX[i] = lastX;
+            particles.positionY[i] = lastY;
+        }
+            break;
+        case CollisionMode::Die:
+            particles.lifetime[i] = 0.f;
+            break;
+        default: break;
+        }
+    }
 }
 
-void ParticleSystem::emit(float dt)
+sf::Uint32 ParticleSystem::emit(float dt, sf::Uint32 allowance)
 {
     const float interval = 1.f / m_emitRate;
+    const auto startCount = m_particles.count;
 
     m_accumulator += dt;
     while (m_accumulator > interval)
     {
         m_accumulator -= interval;
-        for (auto i = 0u; i < m_releaseCount; ++i)
+        for (auto i = 0u; i < m_releaseCount && m_particles.count - startCount < allowance; ++i)
             addParticle(m_position);
     }
+    return m_particles.count - startCount;
 }
 
 Particle::Type ParticleSystem::getType() const
@@ -210,7 +361,7 @@ Particle::Type ParticleSystem::getType() const
 
 sf::Uint32 ParticleSystem::getParticleCount() const
 {
-    return m_particles.size();
+    return m_particles.count;
 }
 
 void ParticleSystem::setNode(Node& n)
@@ -252,59 +403,75 @@ void ParticleSystem::onNotify(Subject& s, const Event& e)
     }
 }
 
+void ParticleSystem::getSnapshot(Snapshot& snapshot) const
+{
+    snapshot.vertices.assign(m_vertices.begin(), m_vertices.begin() + m_particles.count * 4u);
+    snapshot.texture = m_texture;
+    snapshot.normalMap = m_normalMap;
+    snapshot.shader = m_shader;
+    snapshot.blendMode = m_blendMode;
+}
+
 //private
 void ParticleSystem::addParticle(const sf::Vector2f& position)
 {
-    Particle p;
-    p.setPosition(position);
-    p.colour = m_colour;
-    p.lifetime = m_particleLifetime;
-    p.velocity = (m_randVelocity) ? 
+    auto& particles = m_particles;
+    if (particles.count == particles.getCapacity()) return;
+
+    const auto velocity = (m_randVelocity) ? 
         m_randVelocities[Util::Random::value(0, m_randVelocities.size() - 1)] :
         m_initialVelocity;
 
-    m_particles.push_back(p);
-}
-
-void ParticleSystem::addVertex(const sf::Vector2f& position, float u, float v, const sf::Color& colour) const
-{
-    sf::Vertex vert;
-    vert.position = position;
-    vert.texCoords = { u, v };
-    vert.color = colour;
-
-    m_vertices.append(vert);
+    const std::size_t i = particles.count++;
+    particles.positionX[i] = position.x;
+    particles.positionY[i] = position.y;
+    particles.velocityX[i] = velocity.x;
+    particles.velocityY[i] = velocity.y;
+    particles.scaleX[i] = 1.f;
+    particles.scaleY[i] = 1.f;
+    particles.rotation[i] = 0.f;
+    particles.lifetime[i] = m_particleLifetime;
+    particles.colour[i] = m_colour;
 }
 
-void ParticleSystem::updateVertices() const
+void ParticleSystem::updateVertices()
 {
-    sf::Vector2f halfSize = m_particleSize / 2.f;
+    const sf::Vector2f halfSize = m_particleSize / 2.f;
+    const auto& particles = m_particles;
 
-    m_vertices.clear();
-    for (auto& p : m_particles)
+    for (auto i = 0u; i < particles.count; ++i)
     {
-        auto colour = p.colour;
+        auto colour = particles.colour[i];
 
         //make particle fade based on lifetime
-        float ratio = p.lifetime / m_particleLifetime;
+        float ratio = particles.lifetime[i] / m_particleLifetime;
         colour.a = static_cast<sf::Uint8>(255.f * std::max(ratio, 0.f));
 
-        auto t = p.getTransform();
-        addVertex(t.transformPoint(-halfSize.x, -halfSize.y), 0.f, 0.f, colour);
-        addVertex(t.transformPoint(halfSize.x, -halfSize.y), m_texCoords.x, 0.f, colour);
-        addVertex(t.transformPoint(halfSize), m_texCoords.x, m_texCoords.y, colour);
-        addVertex(t.transformPoint(-halfSize.x, halfSize.y), 0.f, m_texCoords.y, colour);
+        //scale then rotate the quad corners about the particle position
+        const float angle = particles.rotation[i] * degToRad;
+        const float cosine = std::cos(angle);
+        const float sine = std::sin(angle);
+        const float x = halfSize.x * particles.scaleX[i];
+        const float y = halfSize.y * particles.scaleY[i];
+        const sf::Vector2f position(particles.positionX[i], particles.positionY[i]);
+
+        sf::Vertex* quad = &m_vertices[i * 4u];
+        quad[0].position = position + sf::Vector2f(-x * cosine + y * sine, -x * sine - y * cosine);
+        quad[1].position = position + sf::Vector2f(x * cosine + y * sine, x * sine - y * cosine);
+        quad[2].position = position + sf::Vector2f(x * cosine - y * sine, x * sine + y * cosine);
+        quad[3].position = position + sf::Vector2f(-x * cosine - y * sine, -x * sine + y * cosine);
+
+        quad[0].texCoords = { 0.f, 0.f };
+        quad[1].texCoords = { m_texCoords.x, 0.f };
+        quad[2].texCoords = m_texCoords;
+        quad[3].texCoords = { 0.f, m_texCoords.y };
+
+        quad[0].color = quad[1].color = quad[2].color = quad[3].color = colour;
     }
 }
 
 void ParticleSystem::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
-    if (m_needsUpdate)
-    {
-        updateVertices();
-        m_needsUpdate = false;
-    }
-
     if (m_shader)
     {
         m_shader->setParameter("u_diffuseMap", sf::Shader::CurrentTexture);
@@ -317,5 +484,22 @@ void ParticleSystem::draw(sf::RenderTarget& rt, sf::RenderStates states) const
     states.texture = m_texture;
     states.shader = m_shader;
     states.blendMode = m_blendMode;
-    rt.draw(m_vertices, states);
+    rt.draw(m_vertices.data(), m_particles.count * 4u, sf::Quads, states);
+}
+
+void ParticleSystem::Snapshot::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    if (shader)
+    {
+        shader->setParameter("u_diffuseMap", sf::Shader::CurrentTexture);
+        if (normalMap)
+        {
+            shader->setParameter("u_normalMap", *normalMap);
+        }
+    }
+
+    states.texture = texture;
+    states.shader = shader;
+    states.blendMode = blendMode;
+    rt.draw(vertices.data(), vertices.size(), sf::Quads, states);
 }
\ No newline at end of file
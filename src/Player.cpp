@@ -59,10 +59,11 @@ namespace
     //animation consts
     const float maxFrameRate = 12.f; //animation varies with player speed so we don't use the framerate in the animation file
 
-    Animation idle("idle", 2, 2);
-    Animation run("run", 0, 5);
-    Animation jump("jump", 6, 6);
-    Animation fall("fall", 7, 7);
+    //used if the animation file is missing any of the clips
+    const Animation idle("idle", 2, 2);
+    const Animation run("run", 0, 5);
+    const Animation jump("jump", 6, 6);
+    const Animation fall("fall", 7, 7);
 
     const sf::Vector2f hatPosition(0.f, -31.f);
 }
@@ -97,7 +98,11 @@ Player::Player(CommandStack& cs, Category::Type type, TextureResource& tr, sf::S
     m_spawnPosition (80.f, 500.f),
     m_powerupSprite ("res/textures/map/item_collected.cra", tr),
     m_flashSprite   (true),
-    m_hasHat        (false)
+    m_hasHat        (false),
+    m_idleClip      (-1),
+    m_runClip       (-1),
+    m_jumpClip      (-1),
+    m_fallClip      (-1)
 {
     assert(type == Category::PlayerOne || type == Category::PlayerTwo);
     if (type == Category::PlayerTwo)
@@ -126,18 +131,12 @@ Player::Player(CommandStack& cs, Category::Type type, TextureResource& tr, sf::S
 
     m_sprite.setShader(shader);
     m_sprite.setFrameRate(maxFrameRate);
-    m_sprite.play(idle);
-
-    //check for overriding animation data
-    const auto& anims = m_sprite.getAnimations();
-    auto result = std::find_if(anims.begin(), anims.end(), FindAnimation("idle"));
-    if (result != anims.end()) idle = *(result);
-    result = std::find_if(anims.begin(), anims.end(), FindAnimation("run"));
-    if (result != anims.end()) run = *(result);
-    result = std::find_if(anims.begin(), anims.end(), FindAnimation("jump_up"));
-    if (result != anims.end()) jump = *(result);
-    result = std::find_if(anims.begin(), anims.end(), FindAnimation("jump_down"));
-    if (result != anims.end()) fall = *(result);
+
+    m_idleClip = m_sprite.getClipId("idle");
+    m_runClip = m_sprite.getClipId("run");
+    m_jumpClip = m_sprite.getClipId("jump_up");
+    m_fallClip = m_sprite.getClipId("jump_down");
+    playClip(m_idleClip, idle);
 
     setSize(static_cast<sf::Vector2f>(m_sprite.getFrameSize()));
 
@@ -298,14 +297,14 @@ void Player::onNotify(Subject& s, const Event& evt)
             switch (evt.player.action)
             {
             case Event::PlayerEvent::Moved:
-                m_sprite.play(run);
+                playClip(m_runClip, run);
                 break;
             case Event::PlayerEvent::StartedFalling:
-                m_sprite.play(fall);
+                playClip(m_fallClip, fall);
                 break;
             case Event::PlayerEvent::Stopped:
             case Event::PlayerEvent::Landed:
-                m_sprite.play(idle);
+                playClip(m_idleClip, idle);
 
                 //make sure friction is set when carrying block
                 if (m_carryingBlock)
@@ -593,7 +592,7 @@ void Player::doJump()
         }
 
         //jump animation
-        m_sprite.play(jump);
+        playClip(m_jumpClip, jump);
     }
     else
     {
@@ -856,4 +855,15 @@ void Player::dropHat(bool raiseEvent)
         m_commandStack.push(c);
         m_hasHat = false;
     }
-}
\ No newline at end of file
+}
+void Player::playClip(sf::Int16 clipId, const Animation& fallback)
+{
+    if (clipId < 0)
+    {
+        m_sprite.play(fallback);
+    }
+    else
+    {
+        m_sprite.playClip(clipId);
+    }
+}
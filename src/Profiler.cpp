@@ -0,0 +1,626 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Profiler.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+//VS2013 has no thread_local, but both compilers support POD thread storage
+#ifdef _MSC_VER
+#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILER_THREAD_LOCAL __thread
+#endif //_MSC_VER
+
+namespace
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    struct Node
+    {
+        std::string name;
+        std::size_t parent;
+        sf::Uint32 depth;
+        std::string path;
+        std::vector<std::size_t> children;
+    };
+
+    struct Frame
+    {
+        float duration = 0.f;
+        std::vector<float> times;
+        std::vector<sf::Uint32> calls;
+        std::vector<sf::Uint32> allocations;
+        std::vector<sf::Uint64> allocationBytes;
+        sf::Uint32 totalAllocations = 0u;
+        sf::Uint64 totalAllocationBytes = 0u;
+    };
+
+    struct Thread
+    {
+        sf::Uint32 index = 0u;
+        std::string name;
+        std::vector<std::size_t> scopeStack;
+    };
+
+    //a single timed scope, or a whole frame when node is the root
+    struct TraceEvent
+    {
+        std::size_t node = 0u;
+        sf::Uint32 thread = 0u;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    const std::size_t maxFrames = 600u;
+    const std::size_t maxTraceEvents = 65536u;
+    //only this much of the ring buffer is written out
+    const std::chrono::seconds traceWindow(5);
+    //stops a run of slow frames each writing a trace
+    const std::chrono::seconds spikeCooldown(5);
+
+    //node 0 is the root which all top level scopes belong to
+    std::mutex mutex;
+    std::vector<Node> nodes = { { "", 0u, 0u, "", {} } };
+    std::unordered_map<std::thread::id, Thread> threads;
+    Frame currentFrame;
+    const Clock::time_point startTime = Clock::now();
+    Clock::time_point frameStart = startTime;
+    std::deque<Frame> frames;
+    std::size_t frameNumber = 0u;
+
+    std::vector<TraceEvent> traceEvents(maxTraceEvents);
+    std::size_t traceHead = 0u;
+    std::size_t traceCount = 0u;
+
+    float spikeThreshold = 0.f;
+    Clock::time_point lastSpikeTrace = startTime - spikeCooldown;
+
+    //allocations may happen on any thread at any time, including before
+    //static initialisation, so are counted without locking or allocating.
+    //scopes past the end of the arrays are counted with the root
+    const std::size_t maxAllocationNodes = 1024u;
+    std::atomic<sf::Uint32> allocationCounts[maxAllocationNodes];
+    std::atomic<sf::Uint64> allocationByteCounts[maxAllocationNodes];
+    PROFILER_THREAD_LOCAL std::size_t activeNode = 0u;
+
+    std::vector<std::string> allocationAssertPaths;
+    std::size_t allocationAssertStart = 0u;
+
+    Thread& getThread()
+    {
+        auto result = threads.find(std::this_thread::get_id());
+        if (result != threads.end()) return result->second;
+
+        auto& thread = threads[std::this_thread::get_id()];
+        thread.index = static_cast<sf::Uint32>(threads.size() - 1);
+        thread.name = "thread " + std::to_string(thread.index);
+        return thread;
+    }
+
+    void addTraceEvent(std::size_t node, sf::Uint32 thread, Clock::time_point start, Clock::time_point end)
+    {
+        auto& evt = traceEvents[traceHead];
+        evt.node = node;
+        evt.thread = thread;
+        evt.start = start;
+        evt.end = end;
+
+        traceHead = (traceHead + 1) % maxTraceEvents;
+        traceCount = std::min(traceCount + 1, maxTraceEvents);
+    }
+
+    std::string escapeJson(const std::string& str)
+    {
+        std::string result;
+        for (auto c : str)
+        {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    sf::Int64 microseconds(Clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - startTime).count();
+    }
+
+    std::size_t findChild(std::size_t parent, const char* name)
+    {
+        for (auto c : nodes[parent].children)
+        {
+            if (nodes[c].name == name) return c;
+        }
+
+        Node node;
+        node.name = name;
+        node.parent = parent;
+        node.depth = (parent == 0) ? 0u : nodes[parent].depth + 1u;
+        node.path = (parent == 0) ? name : nodes[parent].path + "/" + name;
+        nodes.push_back(node);
+
+        const auto index = nodes.size() - 1;
+        nodes[parent].children.push_back(index);
+        currentFrame.times.resize(nodes.size(), 0.f);
+        currentFrame.calls.resize(nodes.size(), 0u);
+        currentFrame.allocations.resize(nodes.size(), 0u);
+        currentFrame.allocationBytes.resize(nodes.size(), 0u);
+        return index;
+    }
+
+    //depth first so that children follow their parents
+    void treeOrder(std::size_t node, std::vector<std::size_t>& order)
+    {
+        if (node != 0) order.push_back(node);
+        for (auto c : nodes[node].children)
+            treeOrder(c, order);
+    }
+
+    float milliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(duration).count();
+    }
+
+    //must be called with the mutex locked
+    void storeFrame()
+    {
+        if (frames.size() == maxFrames)
+        {
+            //reuse the oldest frame's storage
+            frames.push_back(std::move(frames.front()));
+            frames.pop_front();
+            std::swap(frames.back(), currentFrame);
+        }
+        else
+        {
+            frames.push_back(currentFrame);
+        }
+        currentFrame.duration = 0.f;
+        currentFrame.times.assign(nodes.size(), 0.f);
+        currentFrame.calls.assign(nodes.size(), 0u);
+        currentFrame.allocations.assign(nodes.size(), 0u);
+        currentFrame.allocationBytes.assign(nodes.size(), 0u);
+    }
+
+    //must be called with the mutex locked
+    void collectAllocations()
+    {
+        currentFrame.allocations.resize(nodes.size(), 0u);
+        currentFrame.allocationBytes.resize(nodes.size(), 0u);
+        currentFrame.totalAllocations = 0u;
+        currentFrame.totalAllocationBytes = 0u;
+        const std::size_t count = std::min(nodes.size(), maxAllocationNodes);
+        for (auto i = 0u; i < count; ++i)
+        {
+            currentFrame.allocations[i] = allocationCounts[i].exchange(0u);
+            currentFrame.allocationBytes[i] = allocationByteCounts[i].exchange(0u);
+            currentFrame.totalAllocations += currentFrame.allocations[i];
+            currentFrame.totalAllocationBytes += currentFrame.allocationBytes[i];
+        }
+    }
+
+    //returns a description of any allocations made by the watched scopes,
+    //or their children, once the warm up frames have passed
+    std::string checkAllocations()
+    {
+        if (allocationAssertPaths.empty() || frameNumber < allocationAssertStart) return "";
+
+        std::stringstream ss;
+        for (auto i = 1u; i < nodes.size(); ++i)
+        {
+            if (currentFrame.allocations[i] == 0) continue;
+
+            const auto& path = nodes[i].path;
+            for (const auto& watched : allocationAssertPaths)
+            {
+                if (path == watched || path.compare(0, watched.size() + 1, watched + "/") == 0)
+                {
+                    ss << "    " << path << ": " << currentFrame.allocations[i] << " allocations, "
+                        << currentFrame.allocationBytes[i] << " bytes" << std::endl;
+                    break;
+                }
+            }
+        }
+        return ss.str();
+    }
+}
+
+Profiler::Scope::Scope(const char* name, bool topLevel)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& stack = getThread().scopeStack;
+        const std::size_t parent = (topLevel || stack.empty()) ? 0u : stack.back();
+        m_node = findChild(parent, name);
+        stack.push_back(m_node);
+    }
+    activeNode = m_node;
+    m_start = Clock::now();
+}
+
+Profiler::Scope::~Scope()
+{
+    const auto end = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    currentFrame.times[m_node] += milliseconds(end - m_start);
+    currentFrame.calls[m_node]++;
+
+    auto& thread = getThread();
+    thread.scopeStack.pop_back();
+    activeNode = thread.scopeStack.empty() ? 0u : thread.scopeStack.back();
+    addTraceEvent(m_node, thread.index, m_start, end);
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    getThread().name = name;
+}
+
+void Profiler::endFrame()
+{
+    const auto now = Clock::now();
+    bool spike = false;
+    std::string allocationReport;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentFrame.duration = milliseconds(now - frameStart);
+        collectAllocations();
+        allocationReport = checkAllocations();
+        addTraceEvent(0u, getThread().index, frameStart, now);
+        frameStart = now;
+        frameNumber++;
+
+        if (spikeThreshold > 0.f && currentFrame.duration > spikeThreshold
+            && now - lastSpikeTrace > spikeCooldown)
+        {
+            lastSpikeTrace = now;
+            spike = true;
+        }
+        storeFrame();
+    }
+
+    if (spike)
+    {
+        const std::string path = "spike_" + std::to_string(frameNumber) + ".json";
+        if (writeTrace(path))
+            std::cout << "Profiler: frame " << frameNumber << " exceeded " << spikeThreshold << "ms, wrote " << path << std::endl;
+    }
+
+    if (!allocationReport.empty())
+    {
+        std::cerr << "Profiler: allocations in steady state on frame " << frameNumber << std::endl << allocationReport;
+        std::abort();
+    }
+}
+
+void Profiler::recordAllocation(std::size_t bytes)
+{
+    const std::size_t node = (activeNode < maxAllocationNodes) ? activeNode : 0u;
+    allocationCounts[node].fetch_add(1u, std::memory_order_relaxed);
+    allocationByteCounts[node].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Profiler::setAllocationAssert(const std::vector<std::string>& paths, std::size_t warmupFrames)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    allocationAssertPaths = paths;
+    allocationAssertStart = frameNumber + warmupFrames;
+}
+
+sf::Uint32 Profiler::getLastFrameAllocations()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames.empty() ? 0u : frames.back().totalAllocations;
+}
+
+std::size_t Profiler::getFrameCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames.size();
+}
+
+float Profiler::getAverageFrameTime(std::size_t frameCount)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    frameCount = std::min(frameCount, frames.size());
+    if (frameCount == 0) return 0.f;
+
+    float total = 0.f;
+    for (auto f = frames.end() - frameCount; f != frames.end(); ++f)
+        total += f->duration;
+    return total / frameCount;
+}
+
+std::vector<Profiler::Stats> Profiler::getStats(std::size_t frameCount)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    frameCount = std::min(frameCount, frames.size());
+
+    std::vector<std::size_t> order;
+    treeOrder(0, order);
+
+    std::vector<Stats> result;
+    result.reserve(order.size());
+    for (auto n : order)
+    {
+        Stats stats;
+        stats.path = nodes[n].path;
+        stats.name = nodes[n].name;
+        stats.depth = nodes[n].depth;
+
+        for (auto f = frames.end() - frameCount; f != frames.end(); ++f)
+        {
+            //frames recorded before this scope existed are shorter
+            if (n >= f->times.size()) continue;
+            stats.average += f->times[n];
+            stats.max = std::max(stats.max, f->times[n]);
+            stats.calls += f->calls[n];
+            stats.allocations += f->allocations[n];
+            stats.allocationBytes += f->allocationBytes[n];
+        }
+        if (frameCount > 0)
+        {
+            stats.average /= frameCount;
+            stats.calls /= frameCount;
+            stats.allocations /= frameCount;
+            stats.allocationBytes /= frameCount;
+            const auto& last = frames.back();
+            stats.last = (n < last.times.size()) ? last.times[n] : 0.f;
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+bool Profiler::writeCsv(const std::string& path, std::size_t frameCount)
+{
+    std::ofstream file(path);
+    if (!file.good())
+    {
+        std::cerr << "Profiler: failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    frameCount = std::min(frameCount, frames.size());
+
+    std::vector<std::size_t> order;
+    treeOrder(0, order);
+
+    file << "frame,frame_ms";
+#ifdef CRUSH_TRACK_ALLOCATIONS
+    file << ",frame_allocs,frame_alloc_bytes";
+#endif //CRUSH_TRACK_ALLOCATIONS
+    for (auto n : order)
+    {
+        file << "," << nodes[n].path << "_ms," << nodes[n].path << "_calls";
+#ifdef CRUSH_TRACK_ALLOCATIONS
+        file << "," << nodes[n].path << "_allocs," << nodes[n].path << "_alloc_bytes";
+#endif //CRUSH_TRACK_ALLOCATIONS
+    }
+    file << std::endl;
+
+    file << std::fixed << std::setprecision(4);
+    std::size_t index = 0u;
+    for (auto f = frames.end() - frameCount; f != frames.end(); ++f, ++index)
+    {
+        file << index << "," << f->duration;
+#ifdef CRUSH_TRACK_ALLOCATIONS
+        file << "," << f->totalAllocations << "," << f->totalAllocationBytes;
+#endif //CRUSH_TRACK_ALLOCATIONS
+        for (auto n : order)
+        {
+            if (n < f->times.size())
+                file << "," << f->times[n] << "," << f->calls[n];
+            else
+                file << ",0,0";
+#ifdef CRUSH_TRACK_ALLOCATIONS
+            if (n < f->allocations.size())
+                file << "," << f->allocations[n] << "," << f->allocationBytes[n];
+            else
+                file << ",0,0";
+#endif //CRUSH_TRACK_ALLOCATIONS
+        }
+        file << std::endl;
+    }
+    return true;
+}
+
+bool Profiler::writeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.good())
+    {
+        std::cerr << "Profiler: failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    //copy what's needed under the lock so that scopes on other
+    //threads aren't blocked while the file is written
+    std::vector<std::pair<sf::Uint32, std::string>> threadNames;
+    std::vector<std::string> nodeNames;
+    std::vector<TraceEvent> events;
+    events.reserve(maxTraceEvents);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto windowStart = Clock::now() - traceWindow;
+
+        for (const auto& t : threads)
+            threadNames.emplace_back(t.second.index, t.second.name);
+
+        nodeNames.reserve(nodes.size());
+        for (const auto& n : nodes)
+            nodeNames.push_back(n.name);
+
+        //oldest first
+        const std::size_t first = (traceHead + maxTraceEvents - traceCount) % maxTraceEvents;
+        for (auto i = 0u; i < traceCount; ++i)
+        {
+            const auto& evt = traceEvents[(first + i) % maxTraceEvents];
+            if (evt.end >= windowStart) events.push_back(evt);
+        }
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+    for (const auto& t : threadNames)
+    {
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << t.first
+            << ",\"args\":{\"name\":\"" << escapeJson(t.second) << "\"}}," << std::endl;
+    }
+
+    for (const auto& evt : events)
+    {
+        const std::string name = (evt.node == 0) ? "frame" : escapeJson(nodeNames[evt.node]);
+        file << "{\"name\":\"" << name << "\",\"cat\":\"" << ((evt.node == 0) ? "frame" : "scope")
+            << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << evt.thread
+            << ",\"ts\":" << microseconds(evt.start) << ",\"dur\":" << microseconds(evt.end) - microseconds(evt.start) << "}," << std::endl;
+    }
+    //closes the array without needing to track the trailing comma
+    file << "{\"name\":\"trace written\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":"
+        << microseconds(Clock::now()) << "}" << std::endl << "]}" << std::endl;
+    return true;
+}
+
+void Profiler::setSpikeThreshold(float milliseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    spikeThreshold = std::max(0.f, milliseconds);
+}
+
+float Profiler::getSpikeThreshold()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return spikeThreshold;
+}
+
+//-----overlay-----//
+namespace
+{
+    const sf::Uint32 charSize = 24u;
+    const float rowHeight = 26.f;
+    const sf::Vector2f overlayPosition(20.f, 20.f);
+#ifdef CRUSH_TRACK_ALLOCATIONS
+    //leaves room for allocation counts
+    const float barStart = 820.f;
+    const float maxBarWidth = 1000.f;
+#else
+    const float barStart = 620.f;
+    const float maxBarWidth = 1200.f;
+#endif //CRUSH_TRACK_ALLOCATIONS
+    const float pixelsPerMs = 40.f;
+
+    const std::vector<sf::Color> depthColours =
+    {
+        { 255u, 140u, 0u },
+        { 255u, 200u, 40u },
+        { 120u, 220u, 80u },
+        { 60u, 180u, 255u },
+        { 200u, 120u, 255u }
+    };
+
+    void addQuad(sf::VertexArray& va, const sf::FloatRect& rect, const sf::Color& colour)
+    {
+        va.append({ { rect.left, rect.top }, colour });
+        va.append({ { rect.left + rect.width, rect.top }, colour });
+        va.append({ { rect.left + rect.width, rect.top + rect.height }, colour });
+        va.append({ { rect.left, rect.top + rect.height }, colour });
+    }
+}
+
+Profiler::Overlay::Overlay(const sf::Font& font)
+    : m_text    (font),
+    m_bars      (sf::Quads){}
+
+//public
+void Profiler::Overlay::update(std::size_t frameCount)
+{
+    const auto stats = getStats(frameCount);
+    const std::size_t rowCount = stats.size() + 1u;
+    while (m_rows.size() < rowCount)
+        m_rows.push_back(m_text.addText("", charSize));
+
+    m_bars.clear();
+    addQuad(m_bars, { overlayPosition.x - 10.f, overlayPosition.y - 6.f, barStart + maxBarWidth - overlayPosition.x, rowCount * rowHeight + 12.f }, sf::Color(0u, 0u, 0u, 180u));
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "frame " << getAverageFrameTime(frameCount) << "ms";
+#ifdef CRUSH_TRACK_ALLOCATIONS
+    ss << ", last " << getLastFrameAllocations() << " allocs";
+#endif //CRUSH_TRACK_ALLOCATIONS
+    m_text.setString(m_rows[0], ss.str());
+    m_text.setPosition(m_rows[0], overlayPosition);
+    m_text.setVisible(m_rows[0], true);
+
+    for (auto i = 0u; i < stats.size(); ++i)
+    {
+        const auto& s = stats[i];
+        const sf::Vector2f position(overlayPosition.x + s.depth * 20.f, overlayPosition.y + (i + 1) * rowHeight);
+
+        ss.str("");
+        ss << s.name << " " << s.average << " / " << s.max << "ms";
+#ifdef CRUSH_TRACK_ALLOCATIONS
+        ss << " " << std::setprecision(0) << s.allocations << " allocs" << std::setprecision(2);
+#endif //CRUSH_TRACK_ALLOCATIONS
+        m_text.setString(m_rows[i + 1], ss.str());
+        m_text.setPosition(m_rows[i + 1], position);
+        m_text.setVisible(m_rows[i + 1], true);
+
+        const auto& colour = depthColours[s.depth % depthColours.size()];
+        const float barTop = position.y + 4.f;
+        const float barHeight = rowHeight - 8.f;
+        const float maxWidth = std::min(maxBarWidth, s.max * pixelsPerMs);
+        const float averageWidth = std::min(maxBarWidth, s.average * pixelsPerMs);
+        addQuad(m_bars, { barStart, barTop, maxWidth, barHeight }, sf::Color(colour.r / 2u, colour.g / 2u, colour.b / 2u));
+        addQuad(m_bars, { barStart, barTop, averageWidth, barHeight }, colour);
+    }
+
+    for (auto i = rowCount; i < m_rows.size(); ++i)
+        m_text.setVisible(m_rows[i], false);
+}
+
+//private
+void Profiler::Overlay::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    rt.draw(m_bars, states);
+    rt.draw(m_text, states);
+}
\ No newline at end of file
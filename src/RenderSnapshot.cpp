@@ -0,0 +1,184 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <RenderSnapshot.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+
+#include <cassert>
+
+namespace
+{
+    //node transforms only translate, scale and rotate by small amounts
+    //each tick, so blending the matrices is close enough
+    sf::Transform interpolate(const sf::Transform& previous, const sf::Transform& current, float alpha)
+    {
+        const float* a = previous.getMatrix();
+        const float* b = current.getMatrix();
+        auto lerp = [alpha](float x, float y){ return x + (y - x) * alpha; };
+
+        return{ lerp(a[0], b[0]), lerp(a[4], b[4]), lerp(a[12], b[12]),
+                lerp(a[1], b[1]), lerp(a[5], b[5]), lerp(a[13], b[13]),
+                0.f, 0.f, 1.f };
+    }
+}
+
+RenderSnapshot::RenderSnapshot()
+    : m_spriteCount         (0u),
+    m_waterCount            (0u),
+    m_particleCount         (0u),
+    m_interpolationAlpha    (1.f){}
+
+//public
+void RenderSnapshot::clear()
+{
+    m_items.clear();
+    m_copyIndices.clear();
+    m_statics.clear();
+    m_spriteCount = 0u;
+    m_waterCount = 0u;
+    m_particleCount = 0u;
+    m_text.count = 0u;
+}
+
+void RenderSnapshot::setView(const sf::View& view)
+{
+    m_view = view;
+}
+
+void RenderSnapshot::setLights(const LightUniforms& lights, const std::vector<sf::Shader*>& shaders)
+{
+    m_lights = lights;
+    m_shaders = shaders;
+}
+
+void RenderSnapshot::addDrawable(const sf::Drawable& drawable, const sf::Transform& previous, const sf::Transform& current, sf::BlendMode blendMode)
+{
+    Item item;
+    item.previous = previous;
+    item.current = current;
+    item.blendMode = blendMode;
+
+    auto copy = m_copyIndices.find(&drawable);
+    if (copy != m_copyIndices.end())
+    {
+        item.type = m_items[copy->second].type;
+        item.index = m_items[copy->second].index;
+        m_items.push_back(item);
+        return;
+    }
+
+    if (auto sprite = dynamic_cast<const AnimatedSprite*>(&drawable))
+    {
+        item.type = Type::Sprite;
+        item.index = m_spriteCount++;
+        if (item.index < m_sprites.size())
+            m_sprites[item.index] = *sprite;
+        else
+            m_sprites.push_back(*sprite);
+    }
+    else if (auto water = dynamic_cast<const WaterDrawable*>(&drawable))
+    {
+        item.type = Type::Water;
+        item.index = m_waterCount++;
+        if (item.index == m_water.size())
+            m_water.emplace_back();
+        water->getSnapshot(m_water[item.index]);
+    }
+    else
+    {
+        item.type = Type::Static;
+        item.index = m_statics.size();
+        m_statics.push_back(&drawable);
+    }
+
+    m_copyIndices[&drawable] = m_items.size();
+    m_items.push_back(item);
+}
+
+void RenderSnapshot::addParticles(const ParticleSystem& particleSystem)
+{
+    if (m_particleCount == m_particles.size())
+        m_particles.emplace_back();
+    particleSystem.getSnapshot(m_particles[m_particleCount++]);
+}
+
+void RenderSnapshot::setText(const TextBatch& textBatch)
+{
+    textBatch.getSnapshot(m_text);
+}
+
+void RenderSnapshot::setInterpolationAlpha(float alpha)
+{
+    m_interpolationAlpha = alpha;
+}
+
+std::size_t RenderSnapshot::getDrawableCount() const
+{
+    return m_items.size() + m_particleCount;
+}
+
+//private
+void RenderSnapshot::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    for (auto s : m_shaders)
+        m_lights.apply(*s);
+
+    rt.setView(m_view);
+    for (const auto& item : m_items)
+    {
+        sf::RenderStates itemStates = states;
+        itemStates.transform *= interpolate(item.previous, item.current, m_interpolationAlpha);
+        itemStates.blendMode = item.blendMode;
+
+        switch (item.type)
+        {
+        case Type::Sprite:
+            rt.draw(m_sprites[item.index], itemStates);
+            break;
+        case Type::Water:
+            rt.draw(m_water[item.index], itemStates);
+            break;
+        case Type::Static:
+            rt.draw(*m_statics[item.index], itemStates);
+            break;
+        default: assert(false); break;
+        }
+    }
+
+    for (auto i = 0u; i < m_particleCount; ++i)
+        rt.draw(m_particles[i], states);
+
+    if (m_text.font)
+    {
+        if (!m_textBatch)
+            m_textBatch = std::make_unique<TextBatch>(*m_text.font);
+        m_textBatch->applySnapshot(m_text);
+        rt.draw(*m_textBatch, states);
+    }
+}
\ No newline at end of file
@@ -25,10 +25,10 @@ and must not be misrepresented as being the original software.
 source distribution.
 *********************************************************************/
 
-#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
 
 #include <Scene.hpp>
+#include <RenderSnapshot.hpp>
 
 #include <cassert>
 #include <array>
@@ -230,10 +230,7 @@ void Scene::onNotify(Subject& s, const Event& evt)
 void Scene::update(float dt)
 {
     //this assumes all shaders require light data updating
-    //ready for use by any nodes
-
-    //sfml doesn't support array uniforms so this is fudged by using the
-    //underlying array of the transform class
+    //ready for use by any nodes. the uniforms are applied when drawn
     std::array<sf::Vector3f, maxLights> positions;
     std::array<sf::Vector3f, maxLights> colours;
     std::array<float, maxLights> ranges = { 1.f, 1.f, 1.f, 1.f, 1.f, 1.f };
@@ -245,48 +242,47 @@ void Scene::update(float dt)
         ranges[i] = m_lights[i].getRangeInverse();
     }
 
+    m_lightUniforms.sunDirection = m_sunDirection;
+    m_lightUniforms.sunColour = m_sunLight.getColour();
+    m_lightUniforms.ambientColour = m_ambientColour;
 
-    sf::Transform lightPositionsFirst(positions[0].x, positions[0].y, positions[0].z,
-                                    positions[1].x, positions[1].y, positions[1].z, 
-                                    positions[2].x, positions[2].y, positions[2].z);
+    m_lightUniforms.positionsFirst = sf::Transform(positions[0].x, positions[0].y, positions[0].z,
+                                                positions[1].x, positions[1].y, positions[1].z,
+                                                positions[2].x, positions[2].y, positions[2].z);
 
-    sf::Transform lightPositionsSecond(positions[3].x, positions[3].y, positions[3].z,
-                                    positions[4].x, positions[4].y, positions[4].z,
-                                    positions[5].x, positions[5].y, positions[5].z);
+    m_lightUniforms.positionsSecond = sf::Transform(positions[3].x, positions[3].y, positions[3].z,
+                                                positions[4].x, positions[4].y, positions[4].z,
+                                                positions[5].x, positions[5].y, positions[5].z);
 
-    sf::Transform lightColoursFirst(colours[0].x, colours[0].y, colours[0].z,
-                                    colours[1].x, colours[1].y, colours[1].z,
-                                    colours[2].x, colours[2].y, colours[2].z);
+    m_lightUniforms.coloursFirst = sf::Transform(colours[0].x, colours[0].y, colours[0].z,
+                                                colours[1].x, colours[1].y, colours[1].z,
+                                                colours[2].x, colours[2].y, colours[2].z);
 
-    sf::Transform lightColoursSecond(colours[3].x, colours[3].y, colours[3].z,
-                                    colours[4].x, colours[4].y, colours[4].z,
-                                    colours[5].x, colours[5].y, colours[5].z);
+    m_lightUniforms.coloursSecond = sf::Transform(colours[3].x, colours[3].y, colours[3].z,
+                                                colours[4].x, colours[4].y, colours[4].z,
+                                                colours[5].x, colours[5].y, colours[5].z);
 
-    for (auto& s : m_shaders)
-    {
-        s->setParameter("u_directionalLightDirection", m_sunDirection);
-        s->setParameter("u_directionalLightColour", m_sunLight.getColour());
-        s->setParameter("u_ambientColour", m_ambientColour);
-
-        s->setParameter("u_pointLightPositionsFirst", lightPositionsFirst);
-        s->setParameter("u_pointLightPositionsSecond", lightPositionsSecond);
-        s->setParameter("u_pointLightColoursFirst", lightColoursFirst);
-        s->setParameter("u_pointLightColoursSecond", lightColoursSecond);
-        s->setParameter("u_inverseRangesFirst", sf::Vector3f(ranges[0], ranges[1], ranges[2]));
-        s->setParameter("u_inverseRangesSecond", sf::Vector3f(ranges[3], ranges[4], ranges[5]));
-    }
+    m_lightUniforms.inverseRangesFirst = sf::Vector3f(ranges[0], ranges[1], ranges[2]);
+    m_lightUniforms.inverseRangesSecond = sf::Vector3f(ranges[3], ranges[4], ranges[5]);
 
     flush();
 }
 
-//private
-void Scene::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+void Scene::storeTransforms()
 {
-    rt.setView(m_activeCamera->getView());
+    for (auto& c : m_children)
+        c->storeTransform();
+}
+
+void Scene::snapshot(RenderSnapshot& snapshot) const
+{
+    snapshot.setView(m_activeCamera->getView());
+    snapshot.setLights(m_lightUniforms, m_shaders);
     for (const auto& c : m_children)
-        rt.draw(*c);
+        c->snapshot(snapshot, sf::Transform::Identity, sf::Transform::Identity);
 }
 
+//private
 void Scene::flush()
 {
     if (m_deletedList.size())
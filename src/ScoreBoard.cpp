@@ -29,6 +29,7 @@ source distribution.
 #include <Game.hpp>
 #include <Util.hpp>
 #include <Node.hpp>
+#include <RenderSnapshot.hpp>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
@@ -39,13 +40,6 @@ source distribution.
 
 namespace
 {
-    sf::Text playerOneText;
-    sf::Text playerTwoText;
-    sf::Text npcText;
-    //sf::Text timerText;
-
-    sf::Font messageFont;
-
     const sf::Uint16 playerPoints = 100u; //points for killing other player
     const sf::Uint16 crushPoints = 500u; //points for crushing someone
     const sf::Uint16 suicidePoints = 200u; //points deducted for accidentally crushing self
@@ -57,9 +51,9 @@ namespace
     const float initialMessageSpeed = 60.f;
 }
 
-ScoreBoard::ScoreBoard(StateStack& stack, State::Context context)
-    : m_stack               (stack),
-    m_context               (context),
+ScoreBoard::ScoreBoard(State::Context context)
+    : m_context             (context),
+    m_gameOver              (false),
     m_playerOneLives        (5),
     m_playerTwoLives        (-1),
     m_playerOneScore        (0u),
@@ -74,17 +68,17 @@ ScoreBoard::ScoreBoard(StateStack& stack, State::Context context)
     m_playerTwoExtinct      (false),
     m_maxNpcs               (2u),
     m_spawnedNpcs           (0u),
-    m_deadNpcs              (0u)
+    m_deadNpcs              (0u),
+    m_textBatch             (context.gameInstance.getFont("res/fonts/VeraMono.ttf")),
+    m_playerOneText         (m_textBatch.addText("")),
+    m_playerTwoText         (m_textBatch.addText("")),
+    m_npcText               (m_textBatch.addText(""))
 {
-    playerOneText.setFont(context.gameInstance.getFont("res/fonts/VeraMono.ttf"));
-    playerOneText.setPosition(60.f, 10.f );
+    m_textBatch.setPosition(m_playerOneText, { 60.f, 10.f });
     //updateText(Category::PlayerOne);
 
-    playerTwoText.setFont(*playerOneText.getFont());
     //playerTwoText.setString("Press Start");
-    playerTwoText.setPosition(1400.f, 10.f);
-
-    npcText.setFont(*playerOneText.getFont());
+    m_textBatch.setPosition(m_playerTwoText, { 1400.f, 10.f });
 
     //initialise player data from current context
     m_playerOneExtinct = !context.gameData.playerOne.enabled;
@@ -97,9 +91,7 @@ ScoreBoard::ScoreBoard(StateStack& stack, State::Context context)
     m_playerTwoScore = context.gameData.playerTwo.score;
     updateText(Category::PlayerTwo);
 
-    messageFont = context.gameInstance.getFont("res/fonts/VeraMono.ttf");
-
-    //timerText.setFont(messageFont);
+    //timerText.setFont(m_textBatch);
     //timerText.setPosition(60.f, 50.f);
     *m_playerOneHatTime = 0.f;
     *m_playerTwoHatTime = 0.f;
@@ -108,7 +100,12 @@ ScoreBoard::ScoreBoard(StateStack& stack, State::Context context)
 //public
 void ScoreBoard::update(float dt)
 {
-    m_messages.remove_if([](const Message& m){return m.stopped(); });
+    m_messages.remove_if([this](const Message& m)
+    {
+        if (!m.stopped()) return false;
+        m_textBatch.removeText(m.getTextId());
+        return true;
+    });
 
     for (auto& m : m_messages)
         m.update(dt);
@@ -157,7 +154,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
                 if (m_maxNpcs == m_deadNpcs)
                 {
                     //game over, all dead
-                    m_stack.pushState(States::ID::GameOver);
+                    m_gameOver = true;
                     updateGameData();
 
                     //disable player input
@@ -207,7 +204,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
                             //show message
                             m_messages.emplace_back(std::to_string(playerPoints),
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
 
                         case Category::Npc: //p1 killed bad guy
                             m_playerOneScore += crushPoints;
@@ -215,7 +212,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
                             //show message
                             m_messages.emplace_back(std::to_string(crushPoints),
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
 
                             m_playerOneKillStreak++;
                             if ((m_playerOneKillStreak % killStreakStep) == 0)
@@ -248,7 +245,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
 
                             m_messages.emplace_back(msg,
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
                         }
                             break;
                         default: break;
@@ -265,7 +262,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
                             //show message
                             m_messages.emplace_back(std::to_string(playerPoints),
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
 
                         case Category::Npc: //p2 killed bad guy
                             m_playerTwoScore += crushPoints;
@@ -273,7 +270,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
                             //show message
                             m_messages.emplace_back(std::to_string(crushPoints),
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
 
                             m_playerTwoKillStreak++;
                             if (m_playerTwoKillStreak % killStreakStep == 0)
@@ -305,7 +302,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
 
                             m_messages.emplace_back(msg,
                                 sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                                messageFont);
+                                m_textBatch);
                         }
                             break;
                         default: break;
@@ -358,7 +355,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
 
                     m_messages.emplace_back(msg,
                         sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                        messageFont);
+                        m_textBatch);
                 }
                 textUpdateTarget = evt.node.owner;
                 break;
@@ -372,7 +369,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
 
                     m_messages.emplace_back("PAF!",
                         sf::Vector2f(evt.node.positionX, evt.node.positionY),
-                        messageFont);
+                        m_textBatch);
                 }
                 break;
             default: break;
@@ -422,7 +419,7 @@ void ScoreBoard::onNotify(Subject& s, const Event& evt)
             //display message
             m_messages.emplace_back(msg + std::to_string(itemPoints),
                 sf::Vector2f(evt.player.positionX, evt.player.positionY),
-                messageFont);
+                m_textBatch);
 
             m_messages.back().setColour(sf::Color::Yellow);
             updateText(evt.player.playerId);
@@ -485,6 +482,16 @@ void ScoreBoard::setMaxNpcs(sf::Uint8 count)
     updateText(Category::Npc);
 }
 
+bool ScoreBoard::gameOver() const
+{
+    return m_gameOver;
+}
+
+void ScoreBoard::snapshot(RenderSnapshot& snapshot) const
+{
+    snapshot.setText(m_textBatch);
+}
+
 //private
 void ScoreBoard::updateText(Category::Type type)
 {
@@ -494,12 +501,12 @@ void ScoreBoard::updateText(Category::Type type)
         if (m_playerOneLives >= 0)
         {
             ss << "Lives: " << m_playerOneLives << "    Score: " << m_playerOneScore;
-            playerOneText.setString(ss.str());
+            m_textBatch.setString(m_playerOneText, ss.str());
         }
         else if (m_playerOneExtinct)
         {
             ss << "GAME OVER    Score: " << m_playerOneScore;
-            playerOneText.setString(ss.str());
+            m_textBatch.setString(m_playerOneText, ss.str());
         }
         
     }
@@ -508,27 +515,27 @@ void ScoreBoard::updateText(Category::Type type)
         if (m_playerTwoLives >= 0)
         {
             ss << "Lives: " << m_playerTwoLives << "    Score: " << m_playerTwoScore;
-            playerTwoText.setString(ss.str());
+            m_textBatch.setString(m_playerTwoText, ss.str());
         }
         else if (m_playerTwoExtinct)
         {
             ss << "GAME OVER    Score: " << m_playerTwoScore;
-            playerTwoText.setString(ss.str());
+            m_textBatch.setString(m_playerTwoText, ss.str());
         }
     }
     else if (type == Category::Npc)
     {
         ss << "Enemies Remaining: " << (m_maxNpcs - m_spawnedNpcs) << std::endl;
-        npcText.setString(ss.str());
-        Util::Position::centreOrigin(npcText);
-        npcText.setPosition(m_context.defaultView.getCenter() + sf::Vector2f(0.f, -500.f));
+        m_textBatch.setString(m_npcText, ss.str());
+        m_textBatch.centreOrigin(m_npcText);
+        m_textBatch.setPosition(m_npcText, m_context.defaultView.getCenter() + sf::Vector2f(0.f, -500.f));
     }
 
     //not really sure why this is in this function as it's not the obvious place to look
     if (m_playerOneLives < 0 && m_playerTwoLives < 0)
     {
         //Gaaaaaaame Oveeeeer!!!
-        m_stack.pushState(States::ID::GameOver);
+        m_gameOver = true;
         updateGameData();
     }
 }
@@ -564,33 +571,28 @@ void ScoreBoard::disablePlayer(Category::Type player)
 
 void ScoreBoard::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
-    for (const auto& m : m_messages)
-        m_context.renderWindow.draw(m);
-
-    m_context.renderWindow.draw(playerOneText);
-    m_context.renderWindow.draw(playerTwoText);
-    m_context.renderWindow.draw(npcText);
+    //messages and scores are all drawn together by the batch
+    m_context.renderWindow.draw(m_textBatch);
 }
 
 void ScoreBoard::killstreakMessage()
 {
     m_messages.emplace_back("CRUSHTASTIC!",
-        m_context.renderWindow.getView().getCenter(),
-        messageFont, true);
+        m_context.defaultView.getCenter(),
+        m_textBatch, true);
 }
 
 //-----message class-----//
-ScoreBoard::Message::Message(const std::string& text, const sf::Vector2f& position, const sf::Font& font, bool zoom)
+ScoreBoard::Message::Message(const std::string& text, const sf::Vector2f& position, TextBatch& textBatch, bool zoom)
     : m_colour          (sf::Color::White),
     m_transparency      (1.f),
     m_zoom              (zoom),
-    m_text              (text, font, 24u),
+    m_textBatch         (&textBatch),
+    m_textId            (textBatch.addText(text, 24u, true)),
     m_messageSpeed      (initialMessageSpeed)
 {
-    Util::Position::centreOrigin(m_text);
-    m_text.setPosition(position);
-
-    m_text.setStyle(sf::Text::Bold);
+    m_textBatch->centreOrigin(m_textId);
+    m_textBatch->setPosition(m_textId, position);
 }
 
 void ScoreBoard::Message::update(float dt)
@@ -601,18 +603,18 @@ void ScoreBoard::Message::update(float dt)
     if (m_transparency > 0)
     {
         m_colour.a = static_cast<sf::Uint8>(255.f * m_transparency);
-        m_text.setColor(m_colour);
+        m_textBatch->setColour(m_textId, m_colour);
     }
 
     if (m_zoom)
     {
         const float amount = 1.04f + dt;
-        m_text.scale(amount, amount);
+        m_textBatch->setScale(m_textId, m_textBatch->getScale(m_textId) * amount);
     }
     else
     {
         m_messageSpeed += messageAcceleration * dt;
-        m_text.move(0.f, -m_messageSpeed * dt);
+        m_textBatch->move(m_textId, { 0.f, -m_messageSpeed * dt });
     }
 }
 
@@ -626,7 +628,7 @@ bool ScoreBoard::Message::stopped() const
     return (m_transparency <= 0);
 }
 
-void ScoreBoard::Message::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+sf::Uint32 ScoreBoard::Message::getTextId() const
 {
-    rt.draw(m_text, states);
+    return m_textId;
 }
\ No newline at end of file
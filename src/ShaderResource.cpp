@@ -29,6 +29,11 @@ source distribution.
 #include <UberShader.hpp>
 #include <ParticleShaders.hpp>
 #include <PostShaders.hpp>
+#include <Profiler.hpp>
+
+#include <SFML/Window/Context.hpp>
+
+#include <array>
 
 namespace
 {
@@ -44,16 +49,81 @@ namespace
         static const std::string reflection = "#define REFLECT_MAP\n";
         static const std::string environment = "#define SKY_MAP\n";
     }
+
+    const std::array<Shader::Type, 7u> shaderTypes =
+    {
+        Shader::Type::FlatShaded,
+        Shader::Type::NormalMap,
+        Shader::Type::NormalMapSpecular,
+        Shader::Type::Water,
+        Shader::Type::WaterDrop,
+        Shader::Type::Metal,
+        Shader::Type::GaussianBlur
+    };
+}
+
+ShaderResource::ShaderResource(bool compile)
+    : m_compile     (compile),
+    m_compileThread (&ShaderResource::compileAll, this){}
+
+ShaderResource::~ShaderResource()
+{
+    m_compileThread.wait();
 }
 
+//public
 sf::Shader& ShaderResource::get(Shader::Type type)
 {
+    //make sure any precompilation has finished with the shader map
+    m_compileThread.wait();
+
     auto result = m_shaders.find(type);
     if (result != m_shaders.end())
     {
         return *result->second;
     }
 
+    m_shaders.insert(std::make_pair(type, m_compile ? create(type) : std::make_unique<sf::Shader>()));
+    return *m_shaders[type];
+}
+
+void ShaderResource::precompile()
+{
+    if (!m_compile) return;
+
+    m_compileThread.wait();
+    m_compileThread.launch();
+}
+
+void ShaderResource::addBinding(Shader::UniformBinding::Ptr& b)
+{
+    m_uniformBindings.push_back(std::move(b));
+}
+
+void ShaderResource::updateBindings()
+{
+    for (auto& b : m_uniformBindings)
+        b->bind();
+}
+
+//private
+void ShaderResource::compileAll()
+{
+    PROFILE_THREAD_NAME("shader compiler");
+    PROFILE_SCOPE("ShaderResource::compileAll");
+
+    //shaders created in this context are shared with the window's context.
+    //destroying it deactivates the context which flushes the GL commands
+    sf::Context context;
+    for (auto type : shaderTypes)
+    {
+        if (m_shaders.find(type) == m_shaders.end())
+            m_shaders.insert(std::make_pair(type, create(type)));
+    }
+}
+
+Shader::Ptr ShaderResource::create(Shader::Type type)
+{
     //NOTE shader not working properly when using scene lighting? MAKE SURE IT HAS BEEN ADDED TO SCENE SHADERS
     Shader::Ptr shader = std::make_unique<sf::Shader>();
     switch (type)
@@ -88,17 +158,5 @@ sf::Shader& ShaderResource::get(Shader::Type type)
     default: break;
     }
 
-    m_shaders.insert(std::make_pair(type, std::move(shader)));
-    return *m_shaders[type];
-}
-
-void ShaderResource::addBinding(Shader::UniformBinding::Ptr& b)
-{
-    m_uniformBindings.push_back(std::move(b));
+    return shader;
 }
-
-void ShaderResource::updateBindings()
-{
-    for (auto& b : m_uniformBindings)
-        b->bind();
-}
\ No newline at end of file
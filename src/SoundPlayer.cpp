@@ -27,6 +27,7 @@ source distribution.
 
 #include <SoundPlayer.hpp>
 #include <Node.hpp>
+#include <Profiler.hpp>
 
 #include <SFML/Audio/Listener.hpp>
 
@@ -80,7 +81,7 @@ void SoundPlayer::play(AudioId id, const sf::Vector2f& position, bool loop, Node
     m_sounds.emplace_back();
 
     auto& sound = m_sounds.back();
-    sound.setBuffer(m_buffers[id]);
+    sound.setBuffer(getBuffer(id));
     sound.setPosition(position.x, -position.y, 0.f);
     sound.setAttenuation(attenuation);
     sound.setMinDistance(minDistance3D);
@@ -99,7 +100,7 @@ void SoundPlayer::play(AudioId id, const sf::Vector3f& position)
     m_sounds.emplace_back();
 
     auto& sound = m_sounds.back();
-    sound.setBuffer(m_buffers[id]);
+    sound.setBuffer(getBuffer(id));
     sound.setPosition(position.x, -position.y, position.z);
     sound.setAttenuation(attenuation);
     sound.setMinDistance(minDistance3D);
@@ -135,8 +136,16 @@ sf::Vector2f SoundPlayer::getListenerPosition() const
 
 void SoundPlayer::cacheSound(AudioId id, const std::string& path)
 {
-    m_buffers.insert(std::make_pair(id, sf::SoundBuffer()));
-    m_buffers[id].loadFromFile(path);
+    PROFILE_SCOPE("SoundPlayer::cacheSound");
+
+    auto buffer = std::make_unique<sf::SoundBuffer>();
+    buffer->loadFromFile(path);
+    m_buffers[id] = std::move(buffer);
+}
+
+void SoundPlayer::cacheSound(AudioId id, std::unique_ptr<sf::SoundBuffer> buffer)
+{
+    m_buffers[id] = std::move(buffer);
 }
 
 void SoundPlayer::setVolume(float vol)
@@ -155,3 +164,11 @@ void SoundPlayer::flushSounds()
     m_sounds.remove_if([](const sf::Sound& s){return (s.getStatus() == sf::Sound::Stopped); });
     m_loopedSounds.remove_if([](const std::pair<Node*, sf::Sound*>& p){return (p.second->getStatus() == sf::Sound::Stopped); });
 }
+
+const sf::SoundBuffer& SoundPlayer::getBuffer(AudioId id)
+{
+    //ids which were never cached play silently
+    auto& buffer = m_buffers[id];
+    if (!buffer) buffer = std::make_unique<sf::SoundBuffer>();
+    return *buffer;
+}
@@ -28,28 +28,167 @@ source distribution.
 #include <SpriteSheet.hpp>
 #include <Util.hpp>
 #include <JsonUtil.hpp>
+#include <FileSystem.hpp>
 
 #include <SFML/Graphics/Transform.hpp>
 
 #include <picojson.h>
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 
-SpriteSheet::SpriteSheet(const std::string& path)
+namespace
 {
-    std::ifstream file(path);
-    assert(file.good());
-    assert(Util::File::validLength(file));
+    //binary cache layout: header, frame records, then a string table
+    //holding the sheet name followed by each frame's file name
+    const sf::Uint32 cacheIdent = 0x43535343; //CSSC
+    const sf::Uint32 cacheVersion = 2u;
 
-    //read the entire file into memory first
-    std::string jsonString;
-    while (!file.eof())
+    struct CacheHeader
+    {
+        sf::Uint32 ident;
+        sf::Uint32 version;
+        //modified time is only in whole seconds, so the size
+        //catches edits made in the second the cache was written
+        sf::Uint64 modifiedTime;
+        sf::Uint64 fileSize;
+        sf::Uint32 frameCount;
+        sf::Uint32 nameLength;
+    };
+
+    struct CacheFrame
+    {
+        enum Flags
+        {
+            Rotated = 0x1,
+            Trimmed = 0x2
+        };
+        std::array<float, 4u> frame;
+        std::array<float, 4u> spriteSourceSize;
+        std::array<float, 2u> sourceSize;
+        std::array<float, 2u> pivot;
+        sf::Uint32 nameOffset;
+        sf::Uint32 nameLength;
+        sf::Uint32 flags;
+    };
+
+    std::string cachePath(const std::string& path)
+    {
+        return path.substr(0, path.find_last_of('.')) + ".cache";
+    }
+}
+
+SpriteSheet::SpriteSheet(const std::string& path, bool useCache)
+{
+    if (!useCache)
     {
-        std::string temp;
-        file >> temp;
-        jsonString += temp;
+        parseJson(path);
     }
+    else
+    {
+        const auto modifiedTime = FileSystem::getModifiedTime(path);
+        const auto fileSize = FileSystem::getFileSize(path);
+        if (!readCache(path, modifiedTime, fileSize))
+        {
+            parseJson(path);
+            writeCache(path, modifiedTime, fileSize);
+        }
+    }
+
+    m_frameIndices.reserve(m_frames.size());
+    for (auto i = 0u; i < m_frames.size(); ++i)
+        m_frameIndices.insert(std::make_pair(m_frames[i].filename, i));
+}
+
+const std::string& SpriteSheet::getName() const
+{
+    return m_name;
+}
+
+SpriteSheet::Quad SpriteSheet::getFrame(const std::string& name, const sf::Vector2f& position)
+{
+    //TODO cache quads as frame members so if they are requested more than once they don't need to be recreated?
+    //have to make sure not to cache any previous positions
+
+    auto index = m_frameIndices.find(name);
+
+    Quad q = {};
+    if (index != m_frameIndices.end())
+    {
+        const auto result = m_frames.begin() + index->second;
+        auto frame = result->frame;        
+        if (result->rotated) //swap w/h
+        {
+            auto temp = frame.width;
+            frame.width = frame.height;
+            frame.height = temp;
+        }
+
+        std::vector<sf::Vector2f> positions = 
+        {
+            { 0.f, 0.f },
+            { frame.width, 0.f },
+            { frame.width, frame.height },
+            { 0.f, frame.height }
+        };
+
+        if (result->rotated)
+        {
+            sf::Transform t;
+            //pivot coords are normalised
+            t.rotate(-90.f, { frame.width * result->pivot.x, frame.height * result->pivot.y });
+
+            for (auto& p : positions)
+            {
+                p = t.transformPoint(p);
+                p.y += frame.width; //moves origin
+            }
+        }
+
+        std::vector<sf::Vector2f> coords = 
+        {
+            { frame.left, frame.top },
+            { frame.left + frame.width, frame.top },
+            { frame.left + frame.width, frame.top + frame.height },
+            { frame.left, frame.top + frame.height }
+        };
+
+        for (auto i = 0u; i < q.size(); ++i)
+        {
+            q[i].texCoords = coords[i];
+            q[i].position = positions[i] + position;
+        }
+    }
+    else
+    {
+        std::cerr << "Sprite Sheet: " << m_name << ", " << name << " frame not found." << std::endl;
+    }
+    return q;
+}
+
+sf::Vector2i SpriteSheet::getFrameSize(sf::Uint8 index) const
+{
+    assert(index < m_frames.size());
+    return sf::Vector2i(static_cast<int>(m_frames[index].spriteSourceSize.width),
+                        static_cast<int>(m_frames[index].spriteSourceSize.height));
+}
+
+sf::Uint8 SpriteSheet::getFrameCount() const
+{
+    return m_frames.size();
+}
+
+//private
+void SpriteSheet::parseJson(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    assert(file.good());
+    assert(Util::File::validLength(file));
+
+    //read the entire file into memory in one go
+    std::string jsonString((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     assert(!jsonString.empty());
     file.close();
 
@@ -124,83 +263,90 @@ SpriteSheet::SpriteSheet(const std::string& path)
     }
 }
 
-const std::string& SpriteSheet::getName() const
-{
-    return m_name;
-}
-
-SpriteSheet::Quad SpriteSheet::getFrame(const std::string& name, const sf::Vector2f& position)
+bool SpriteSheet::readCache(const std::string& path, sf::Uint64 modifiedTime, sf::Uint64 fileSize)
 {
-    //TODO cache quads as frame members so if they are requested more than once they don't need to be recreated?
-    //have to make sure not to cache any previous positions
-
-    auto result = std::find_if(m_frames.begin(), m_frames.end(),
-        [&name](const Frame& f)
+    FileSystem::MappedFile file(cachePath(path));
+    if (!file.valid() || file.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.ident != cacheIdent
+        || header.version != cacheVersion
+        || header.modifiedTime != modifiedTime
+        || header.fileSize != fileSize)
     {
-        return (f.filename == name); 
-    });
-
-    Quad q = {};
-    if (result != m_frames.end())
-    {       
-        auto frame = result->frame;        
-        if (result->rotated) //swap w/h
-        {
-            auto temp = frame.width;
-            frame.width = frame.height;
-            frame.height = temp;
-        }
-
-        std::vector<sf::Vector2f> positions = 
-        {
-            { 0.f, 0.f },
-            { frame.width, 0.f },
-            { frame.width, frame.height },
-            { 0.f, frame.height }
-        };
+        return false;
+    }
 
-        if (result->rotated)
-        {
-            sf::Transform t;
-            //pivot coords are normalised
-            t.rotate(-90.f, { frame.width * result->pivot.x, frame.height * result->pivot.y });
+    const std::size_t recordsSize = header.frameCount * sizeof(CacheFrame);
+    if (file.size() < sizeof(header) + recordsSize + header.nameLength) return false;
 
-            for (auto& p : positions)
-            {
-                p = t.transformPoint(p);
-                p.y += frame.width; //moves origin
-            }
-        }
+    const char* records = file.data() + sizeof(header);
+    const char* strings = records + recordsSize;
+    const std::size_t stringsSize = file.size() - (sizeof(header) + recordsSize);
 
-        std::vector<sf::Vector2f> coords = 
-        {
-            { frame.left, frame.top },
-            { frame.left + frame.width, frame.top },
-            { frame.left + frame.width, frame.top + frame.height },
-            { frame.left, frame.top + frame.height }
-        };
+    m_name.assign(strings, header.nameLength);
 
-        for (auto i = 0u; i < q.size(); ++i)
+    m_frames.resize(header.frameCount);
+    for (auto i = 0u; i < header.frameCount; ++i)
+    {
+        CacheFrame cf;
+        std::memcpy(&cf, records + (i * sizeof(CacheFrame)), sizeof(cf));
+        //written so a corrupt offset can't wrap around
+        if (cf.nameOffset > stringsSize || cf.nameLength > stringsSize - cf.nameOffset)
         {
-            q[i].texCoords = coords[i];
-            q[i].position = positions[i] + position;
+            m_frames.clear();
+            m_name.clear();
+            return false;
         }
+
+        auto& frame = m_frames[i];
+        frame.filename.assign(strings + cf.nameOffset, cf.nameLength);
+        frame.frame = { cf.frame[0], cf.frame[1], cf.frame[2], cf.frame[3] };
+        frame.spriteSourceSize = { cf.spriteSourceSize[0], cf.spriteSourceSize[1], cf.spriteSourceSize[2], cf.spriteSourceSize[3] };
+        frame.sourceSize = { cf.sourceSize[0], cf.sourceSize[1] };
+        frame.pivot = { cf.pivot[0], cf.pivot[1] };
+        frame.rotated = (cf.flags & CacheFrame::Rotated) != 0;
+        frame.trimmed = (cf.flags & CacheFrame::Trimmed) != 0;
     }
-    else
-    {
-        std::cerr << "Sprite Sheet: " << m_name << ", " << name << " frame not found." << std::endl;
-    }
-    return q;
+    return true;
 }
 
-sf::Vector2i SpriteSheet::getFrameSize(sf::Uint8 index) const
+void SpriteSheet::writeCache(const std::string& path, sf::Uint64 modifiedTime, sf::Uint64 fileSize) const
 {
-    assert(index < m_frames.size());
-    return sf::Vector2i(static_cast<int>(m_frames[index].spriteSourceSize.width),
-                        static_cast<int>(m_frames[index].spriteSourceSize.height));
-}
+    if (modifiedTime == 0 || m_frames.empty()) return;
+
+    CacheHeader header;
+    header.ident = cacheIdent;
+    header.version = cacheVersion;
+    header.modifiedTime = modifiedTime;
+    header.fileSize = fileSize;
+    header.frameCount = static_cast<sf::Uint32>(m_frames.size());
+    header.nameLength = static_cast<sf::Uint32>(m_name.size());
+
+    std::vector<CacheFrame> records(m_frames.size());
+    std::string strings = m_name;
+    for (auto i = 0u; i < m_frames.size(); ++i)
+    {
+        const auto& frame = m_frames[i];
+        auto& cf = records[i];
+        cf.frame = { { frame.frame.left, frame.frame.top, frame.frame.width, frame.frame.height } };
+        cf.spriteSourceSize = { { frame.spriteSourceSize.left, frame.spriteSourceSize.top, frame.spriteSourceSize.width, frame.spriteSourceSize.height } };
+        cf.sourceSize = { { frame.sourceSize.x, frame.sourceSize.y } };
+        cf.pivot = { { frame.pivot.x, frame.pivot.y } };
+        cf.nameOffset = static_cast<sf::Uint32>(strings.size());
+        cf.nameLength = static_cast<sf::Uint32>(frame.filename.size());
+        cf.flags = (frame.rotated ? static_cast<sf::Uint32>(CacheFrame::Rotated) : 0u) | (frame.trimmed ? static_cast<sf::Uint32>(CacheFrame::Trimmed) : 0u);
+        strings += frame.filename;
+    }
 
-sf::Uint8 SpriteSheet::getFrameCount() const
-{
-    return m_frames.size();
+    std::ofstream file(cachePath(path), std::ios::binary | std::ios::trunc);
+    if (!file.good())
+    {
+        std::cerr << "Sprite Sheet: unable to write cache for " << path << std::endl;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CacheFrame));
+    file.write(strings.data(), strings.size());
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ source distribution.
 #include <Resource.hpp>
 #include <Game.hpp>
 #include <Util.hpp>
+#include <Profiler.hpp>
 
 
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -37,6 +38,7 @@ source distribution.
 State::Context::Context(sf::RenderWindow& window, Game& game, GameData& gd)
     : renderWindow  (window),
     gameInstance    (game),
+    jobSystem       (game.getJobSystem()),
     gameData        (gd)
 {
 
@@ -51,6 +53,7 @@ State::State(StateStack& stateStack, Context context)
     m_loadingSprite     ("res/textures/characters/robot.cra", context.gameInstance.getTextureResource()),
     m_loadingText       ("Loading..", context.gameInstance.getFont("res/fonts/VeraMono.ttf")),
     m_threadRunning     (false),
+    m_loadingProgress   (0.f),
     m_loadingThread     (&State::updateLoadingScreen, this){}
 
 //protected
@@ -89,10 +92,16 @@ void State::launchLoadingScreen()
     m_loadingText.move(0.f, 60.f);
 
     m_context.renderWindow.setActive(false);
+    m_loadingProgress = 0.f;
     m_threadRunning = true;
     m_loadingThread.launch();
 }
 
+void State::setLoadingProgress(float progress)
+{
+    m_loadingProgress = progress;
+}
+
 void State::quitLoadingScreen()
 {
     m_threadRunning = false;
@@ -103,8 +112,21 @@ void State::quitLoadingScreen()
 //private
 void State::updateLoadingScreen()
 {
+    PROFILE_THREAD_NAME("loading screen");
+
+    sf::Int32 lastPercent = -1;
     while (m_threadRunning)
     {
+        PROFILE_SCOPE("State::updateLoadingScreen");
+
+        const sf::Int32 percent = static_cast<sf::Int32>(m_loadingProgress * 100.f);
+        if (percent != lastPercent)
+        {
+            m_loadingText.setString("Loading.. " + std::to_string(percent) + "%");
+            Util::Position::centreOrigin(m_loadingText);
+            lastPercent = percent;
+        }
+
         m_loadingSprite.update(m_threadClock.restart().asSeconds());
         m_context.renderWindow.clear();
         m_context.renderWindow.draw(m_loadingSprite);
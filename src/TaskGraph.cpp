@@ -0,0 +1,201 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <TaskGraph.hpp>
+#include <Profiler.hpp>
+
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cassert>
+
+namespace
+{
+    bool shares(const std::vector<std::string>& a, const std::vector<std::string>& b)
+    {
+        for (const auto& s : a)
+        {
+            if (std::find(b.begin(), b.end(), s) != b.end()) return true;
+        }
+        return false;
+    }
+
+    std::string join(const std::vector<std::string>& strings)
+    {
+        std::string result;
+        for (const auto& s : strings)
+        {
+            if (!result.empty()) result += ", ";
+            result += s;
+        }
+        return (result.empty()) ? "-" : result;
+    }
+}
+
+TaskGraph::TaskGraph(JobSystem& jobSystem)
+    : m_jobSystem   (jobSystem),
+    m_parallel      (true){}
+
+//public
+void TaskGraph::addTask(const std::string& name, const Task& task, const std::vector<std::string>& reads, const std::vector<std::string>& writes)
+{
+    auto node = std::make_unique<Node>();
+    node->name = name;
+    node->task = task;
+    node->reads = reads;
+    node->writes = writes;
+    node->waitCount = 0u;
+
+    const auto index = m_nodes.size();
+    for (auto i = 0u; i < m_nodes.size(); ++i)
+    {
+        const auto& other = *m_nodes[i];
+        if (shares(other.writes, reads) || shares(other.writes, writes) || shares(other.reads, writes))
+        {
+            node->dependencies.push_back(i);
+            m_nodes[i]->dependents.push_back(index);
+        }
+    }
+    m_nodes.push_back(std::move(node));
+}
+
+void TaskGraph::run(float dt)
+{
+    if (!m_parallel)
+    {
+        sf::Clock clock;
+        for (auto& n : m_nodes)
+        {
+            clock.restart();
+            {
+                PROFILE_TASK(n->name.c_str());
+                n->task(dt);
+            }
+            recordRunTime(*n, clock.getElapsedTime().asSeconds() * 1000.f);
+        }
+        return;
+    }
+
+    for (auto& n : m_nodes)
+        n->waitCount = n->dependencies.size();
+
+    JobSystem::Counter counter;
+    for (auto i = 0u; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i]->dependencies.empty())
+            m_jobSystem.run([this, i, dt, &counter](){ runNode(i, dt, counter); }, counter);
+    }
+    m_jobSystem.wait(counter);
+}
+
+void TaskGraph::setParallel(bool parallel)
+{
+    m_parallel = parallel;
+}
+
+bool TaskGraph::parallel() const
+{
+    return m_parallel;
+}
+
+std::string TaskGraph::dump() const
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    for (const auto& n : m_nodes)
+    {
+        std::vector<std::string> dependencies;
+        for (auto d : n->dependencies) dependencies.push_back(m_nodes[d]->name);
+
+        ss << n->name << " (" << n->lastRunTime << "ms)" << std::endl;
+        ss << "    reads: " << join(n->reads) << std::endl;
+        ss << "    writes: " << join(n->writes) << std::endl;
+        ss << "    waits for: " << join(dependencies) << std::endl;
+    }
+
+    ss << "digraph tasks {" << std::endl;
+    for (const auto& n : m_nodes)
+    {
+        ss << "    \"" << n->name << "\";" << std::endl;
+        for (auto d : n->dependents)
+            ss << "    \"" << n->name << "\" -> \"" << m_nodes[d]->name << "\";" << std::endl;
+    }
+    ss << "}" << std::endl;
+
+    return ss.str();
+}
+
+std::string TaskGraph::report() const
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << std::left << std::setw(20) << "task" << std::right << std::setw(10) << "runs"
+        << std::setw(12) << "mean ms" << std::setw(12) << "max ms" << std::setw(12) << "total ms" << std::endl;
+
+    double total = 0.0;
+    for (const auto& n : m_nodes)
+    {
+        const double mean = (n->runCount > 0) ? n->totalRunTime / n->runCount : 0.0;
+        ss << std::left << std::setw(20) << n->name << std::right << std::setw(10) << n->runCount
+            << std::setw(12) << mean << std::setw(12) << n->maxRunTime << std::setw(12) << n->totalRunTime << std::endl;
+        total += n->totalRunTime;
+    }
+    ss << std::left << std::setw(20) << "all tasks" << std::right << std::setw(46) << total << std::endl;
+
+    return ss.str();
+}
+
+//private
+void TaskGraph::runNode(std::size_t index, float dt, JobSystem::Counter& counter)
+{
+    auto& node = *m_nodes[index];
+
+    sf::Clock clock;
+    {
+        PROFILE_TASK(node.name.c_str());
+        node.task(dt);
+    }
+    recordRunTime(node, clock.getElapsedTime().asSeconds() * 1000.f);
+
+    //queue anything which was only waiting on this
+    for (auto d : node.dependents)
+    {
+        assert(m_nodes[d]->waitCount > 0);
+        if (--m_nodes[d]->waitCount == 0)
+            m_jobSystem.run([this, d, dt, &counter](){ runNode(d, dt, counter); }, counter);
+    }
+}
+
+void TaskGraph::recordRunTime(Node& node, float time)
+{
+    node.lastRunTime = time;
+    node.maxRunTime = std::max(node.maxRunTime, time);
+    node.totalRunTime += time;
+    node.runCount++;
+}
\ No newline at end of file
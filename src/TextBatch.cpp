@@ -0,0 +1,396 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <TextBatch.hpp>
+#include <GlyphCache.hpp>
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace
+{
+    sf::Vector2f centre(const sf::FloatRect& bounds)
+    {
+        return{ std::floor(bounds.width / 2.f), std::floor(bounds.height / 2.f) };
+    }
+}
+
+TextBatch::TextBatch(const sf::Font& font)
+    : m_font(font)
+{
+
+}
+
+//public
+sf::Uint32 TextBatch::addText(const std::string& string, sf::Uint32 charSize, bool bold)
+{
+    sf::Uint32 id = 0u;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_texts[id] = Text();
+    }
+    else
+    {
+        id = m_texts.size();
+        m_texts.emplace_back();
+    }
+
+    auto& text = m_texts[id];
+    text.string = string;
+    text.charSize = charSize;
+    text.bold = bold;
+    markDirty(text, true);
+
+    return id;
+}
+
+void TextBatch::removeText(sf::Uint32 id)
+{
+    auto& text = getText(id);
+    markDirty(text);
+    text.active = false;
+    text.glyphs.clear();
+    text.vertices.clear();
+    m_freeIds.push_back(id);
+}
+
+void TextBatch::setString(sf::Uint32 id, const std::string& string)
+{
+    auto& text = getText(id);
+    if (text.string != string)
+    {
+        text.string = string;
+        markDirty(text, true);
+    }
+}
+
+void TextBatch::setPosition(sf::Uint32 id, const sf::Vector2f& position)
+{
+    auto& text = getText(id);
+    text.position = position;
+    markDirty(text);
+}
+
+const sf::Vector2f& TextBatch::getPosition(sf::Uint32 id) const
+{
+    return getText(id).position;
+}
+
+void TextBatch::move(sf::Uint32 id, const sf::Vector2f& amount)
+{
+    auto& text = getText(id);
+    text.position += amount;
+    markDirty(text);
+}
+
+void TextBatch::setOrigin(sf::Uint32 id, const sf::Vector2f& origin)
+{
+    auto& text = getText(id);
+    text.origin = origin;
+    text.centred = false;
+    markDirty(text);
+}
+
+void TextBatch::setScale(sf::Uint32 id, float scale)
+{
+    auto& text = getText(id);
+    text.scale = scale;
+    markDirty(text);
+}
+
+float TextBatch::getScale(sf::Uint32 id) const
+{
+    return getText(id).scale;
+}
+
+void TextBatch::setColour(sf::Uint32 id, const sf::Color& colour)
+{
+    auto& text = getText(id);
+    if (text.colour != colour)
+    {
+        text.colour = colour;
+        markDirty(text);
+    }
+}
+
+void TextBatch::setVisible(sf::Uint32 id, bool visible)
+{
+    auto& text = getText(id);
+    if (text.visible != visible)
+    {
+        text.visible = visible;
+        markDirty(text);
+    }
+}
+
+sf::FloatRect TextBatch::getLocalBounds(sf::Uint32 id) const
+{
+    auto& text = m_texts[id];
+    assert(text.active);
+    if (text.layoutDirty) layout(text);
+    return text.bounds;
+}
+
+sf::FloatRect TextBatch::getGlobalBounds(sf::Uint32 id) const
+{
+    auto bounds = getLocalBounds(id);
+    auto& text = m_texts[id];
+    if (text.centred) text.origin = centre(bounds);
+    bounds.left = (bounds.left - text.origin.x) * text.scale + text.position.x;
+    bounds.top = (bounds.top - text.origin.y) * text.scale + text.position.y;
+    bounds.width *= text.scale;
+    bounds.height *= text.scale;
+    return bounds;
+}
+
+void TextBatch::centreOrigin(sf::Uint32 id)
+{
+    auto& text = getText(id);
+    text.centred = true;
+    markDirty(text);
+}
+
+void TextBatch::getSnapshot(Snapshot& snapshot) const
+{
+    snapshot.font = &m_font;
+    snapshot.count = 0u;
+    for (const auto& text : m_texts)
+    {
+        if (!text.active || !text.visible) continue;
+
+        if (snapshot.count == snapshot.texts.size())
+            snapshot.texts.emplace_back();
+
+        auto& copy = snapshot.texts[snapshot.count++];
+        copy.string = text.string;
+        copy.charSize = text.charSize;
+        copy.bold = text.bold;
+        copy.position = text.position;
+        copy.origin = text.origin;
+        copy.centred = text.centred;
+        copy.scale = text.scale;
+        copy.colour = text.colour;
+    }
+}
+
+void TextBatch::applySnapshot(const Snapshot& snapshot)
+{
+    assert(snapshot.font == &m_font);
+
+    //texts are matched by index, which stays the same between snapshots
+    //unless a text is added or removed in the source batch
+    for (auto i = snapshot.count; i < m_texts.size(); ++i)
+    {
+        if (m_texts[i].active) m_dirtyPages[m_texts[i].charSize] = true;
+    }
+    const auto oldCount = m_texts.size();
+    m_texts.resize(snapshot.count);
+    m_freeIds.clear();
+
+    for (auto i = 0u; i < snapshot.count; ++i)
+    {
+        const auto& copy = snapshot.texts[i];
+        auto& text = m_texts[i];
+
+        const bool layout = (i >= oldCount || !text.active || !text.visible
+            || text.string != copy.string || text.charSize != copy.charSize || text.bold != copy.bold);
+        const bool changed = (layout || text.position != copy.position || text.centred != copy.centred
+            || (!copy.centred && text.origin != copy.origin) || text.scale != copy.scale || text.colour != copy.colour);
+        if (!changed) continue;
+
+        if (text.charSize != copy.charSize) m_dirtyPages[text.charSize] = true;
+
+        text.string = copy.string;
+        text.charSize = copy.charSize;
+        text.bold = copy.bold;
+        text.position = copy.position;
+        if (!copy.centred) text.origin = copy.origin;
+        text.centred = copy.centred;
+        text.scale = copy.scale;
+        text.colour = copy.colour;
+        text.visible = true;
+        text.active = true;
+        markDirty(text, layout);
+    }
+}
+
+//private
+TextBatch::Text::Text()
+    : charSize  (30u),
+    bold        (false),
+    centred     (false),
+    scale       (1.f),
+    colour      (sf::Color::White),
+    visible     (true),
+    active      (true),
+    layoutDirty (true){}
+
+TextBatch::Text& TextBatch::getText(sf::Uint32 id)
+{
+    assert(id < m_texts.size() && m_texts[id].active);
+    return m_texts[id];
+}
+
+const TextBatch::Text& TextBatch::getText(sf::Uint32 id) const
+{
+    assert(id < m_texts.size() && m_texts[id].active);
+    return m_texts[id];
+}
+
+void TextBatch::markDirty(Text& text, bool layout)
+{
+    text.layoutDirty |= layout;
+    text.vertices.clear(); //empty vertices are regenerated on draw
+    m_dirtyPages[text.charSize] = true;
+}
+
+void TextBatch::layout(Text& text) const
+{
+    //this follows sf::Text so strings look the same when drawn with either
+    text.glyphs.clear();
+    text.layoutDirty = false;
+
+    GlyphCache::touch(m_font, ' ', text.charSize, text.bold);
+    const float hspace = m_font.getGlyph(L' ', text.charSize, text.bold).advance;
+    const float vspace = static_cast<float>(m_font.getLineSpacing(text.charSize));
+
+    float x = 0.f;
+    float y = static_cast<float>(text.charSize);
+    float minX = static_cast<float>(text.charSize);
+    float minY = static_cast<float>(text.charSize);
+    float maxX = 0.f;
+    float maxY = 0.f;
+
+    sf::Uint32 prevChar = 0u;
+    for (auto c : text.string)
+    {
+        sf::Uint32 curChar = static_cast<sf::Uint8>(c);
+        x += static_cast<float>(m_font.getKerning(prevChar, curChar, text.charSize));
+        prevChar = curChar;
+
+        if (curChar == ' ' || curChar == '\t' || curChar == '\n')
+        {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+
+            switch (curChar)
+            {
+            case ' ': x += hspace; break;
+            case '\t': x += hspace * 4.f; break;
+            case '\n': y += vspace; x = 0.f; break;
+            }
+
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        GlyphCache::touch(m_font, curChar, text.charSize, text.bold);
+        const auto& glyph = m_font.getGlyph(curChar, text.charSize, text.bold);
+
+        const float left = glyph.bounds.left;
+        const float top = glyph.bounds.top;
+        const float right = glyph.bounds.left + glyph.bounds.width;
+        const float bottom = glyph.bounds.top + glyph.bounds.height;
+
+        const float u1 = static_cast<float>(glyph.textureRect.left);
+        const float v1 = static_cast<float>(glyph.textureRect.top);
+        const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width);
+        const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height);
+
+        text.glyphs.emplace_back(sf::Vector2f(x + left, y + top), sf::Vector2f(u1, v1));
+        text.glyphs.emplace_back(sf::Vector2f(x + right, y + top), sf::Vector2f(u2, v1));
+        text.glyphs.emplace_back(sf::Vector2f(x + right, y + bottom), sf::Vector2f(u2, v2));
+        text.glyphs.emplace_back(sf::Vector2f(x + left, y + bottom), sf::Vector2f(u1, v2));
+
+        minX = std::min(minX, x + left);
+        maxX = std::max(maxX, x + right);
+        minY = std::min(minY, y + top);
+        maxY = std::max(maxY, y + bottom);
+
+        x += glyph.advance;
+    }
+
+    text.bounds = { minX, minY, maxX - minX, maxY - minY };
+}
+
+void TextBatch::transform(Text& text) const
+{
+    if (text.layoutDirty) layout(text);
+    if (text.centred) text.origin = centre(text.bounds);
+
+    text.vertices.resize(text.glyphs.size());
+    for (auto i = 0u; i < text.glyphs.size(); ++i)
+    {
+        const auto& glyph = text.glyphs[i];
+        auto& vertex = text.vertices[i];
+        vertex.position = ((glyph.position - text.origin) * text.scale) + text.position;
+        vertex.texCoords = glyph.texCoords;
+        vertex.color = text.colour;
+    }
+}
+
+void TextBatch::updatePages() const
+{
+    for (auto& dirty : m_dirtyPages)
+    {
+        if (!dirty.second) continue;
+
+        auto& page = m_pages[dirty.first];
+        page.setPrimitiveType(sf::Quads);
+        page.clear();
+
+        for (auto& text : m_texts)
+        {
+            if (!text.active || !text.visible || text.charSize != dirty.first) continue;
+            if (text.vertices.empty()) transform(text);
+
+            for (const auto& v : text.vertices)
+                page.append(v);
+        }
+        dirty.second = false;
+    }
+}
+
+void TextBatch::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    updatePages();
+
+    for (const auto& page : m_pages)
+    {
+        if (page.second.getVertexCount() == 0) continue;
+        states.texture = &m_font.getTexture(page.first);
+        rt.draw(page.second, states);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*********************************************************************
+Matt Marchant 2014 - 2015
+http://trederia.blogspot.com
+
+Crush - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Resource.hpp>
+
+#include <sstream>
+#include <iomanip>
+
+namespace
+{
+    std::string toKiloBytes(std::size_t bytes)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << (static_cast<float>(bytes) / 1024.f) << "KB";
+        return ss.str();
+    }
+}
+
+std::vector<std::string> TextureResource::getMemoryReport() const
+{
+    std::vector<std::string> report;
+    std::size_t uniqueBytes = 0u;
+    std::size_t referencedBytes = 0u;
+    long handleCount = 0;
+
+    for (const auto& r : getResources())
+    {
+        const auto size = r.second.handle->getSize();
+        const std::size_t bytes = size.x * size.y * 4u;
+        //the cache itself holds one reference
+        const long refs = r.second.handle.useCount() - 1;
+
+        uniqueBytes += bytes;
+        referencedBytes += bytes * refs;
+        handleCount += refs;
+
+        report.push_back(r.first + ": " + std::to_string(size.x) + "x" + std::to_string(size.y)
+            + ", " + toKiloBytes(bytes) + ", " + std::to_string(refs) + " handles"
+            + ((r.second.handle.getStatus() == Resource::Status::Fallback) ? " (FAILED)" : ""));
+    }
+
+    report.push_back("unique: " + std::to_string(getResources().size()) + " textures, " + toKiloBytes(uniqueBytes));
+    report.push_back("referenced: " + std::to_string(handleCount) + " handles, " + toKiloBytes(referencedBytes));
+    return report;
+}
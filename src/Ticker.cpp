@@ -32,9 +32,9 @@ source distribution.
 #include <cassert>
 
 Ticker::Ticker(sf::Font& font)
-    : m_font    (font),
-    m_speed     (100.f),
-    m_totalWidth(0.f)
+    : m_textBatch   (font),
+    m_speed         (100.f),
+    m_totalWidth    (0.f)
 {
 
 }
@@ -47,21 +47,21 @@ void Ticker::update(float dt)
     {
         if (i == m_messages.begin())
         {
-            i->move(-m_speed * dt, 0.f);
+            m_textBatch.move(*i, { -m_speed * dt, 0.f });
         }
         else
         {
             auto j = std::prev(i);
-            if (!j->getGlobalBounds().intersects(i->getGlobalBounds()))
+            if (!m_textBatch.getGlobalBounds(*j).intersects(m_textBatch.getGlobalBounds(*i)))
             {
-                i->move(-m_speed * dt, 0.f);
+                m_textBatch.move(*i, { -m_speed * dt, 0.f });
             }
         }
 
-        auto lb = i->getLocalBounds();
-        if (i->getPosition().x + lb.width < 0)
+        auto lb = m_textBatch.getLocalBounds(*i);
+        if (m_textBatch.getPosition(*i).x + lb.width < 0)
         {
-            i->move(std::max(m_size.width, m_totalWidth) + lb.width, 0.f);
+            m_textBatch.move(*i, { std::max(m_size.width, m_totalWidth) + lb.width, 0.f });
         }
     }
 
@@ -69,9 +69,9 @@ void Ticker::update(float dt)
 
 void Ticker::addItem(const std::string& text)
 {
-    m_messages.emplace_back(text, m_font, static_cast<sf::Uint32>(m_size.height * 0.8f));
-    m_messages.back().setPosition(m_size.width, m_size.height * 0.1f);
-    m_totalWidth += m_messages.back().getLocalBounds().width;
+    m_messages.push_back(m_textBatch.addText(text, static_cast<sf::Uint32>(m_size.height * 0.8f)));
+    m_textBatch.setPosition(m_messages.back(), { m_size.width, m_size.height * 0.1f });
+    m_totalWidth += m_textBatch.getLocalBounds(m_messages.back()).width;
 }
 
 void Ticker::setSpeed(float speed)
@@ -94,6 +94,5 @@ sf::Uint16 Ticker::getMessageCount() const
 void Ticker::draw(sf::RenderTarget& rt, sf::RenderStates states)const
 {
     states.transform *= getTransform();
-    for (const auto& t : m_messages)
-        rt.draw(t, states);
+    rt.draw(m_textBatch, states);
 }
\ No newline at end of file
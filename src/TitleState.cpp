@@ -73,6 +73,9 @@ TitleState::TitleState(StateStack& stack, Context context)
     Util::Position::centreOrigin(bigText);
     bigText.setPosition(titleText.getPosition() - sf::Vector2f(0.f, bigText.getLocalBounds().height + 20.f));
 
+    //compile shaders while waiting for the player
+    context.gameInstance.getShaderResource().precompile();
+
     //context.gameInstance.playMusic(music);
 }
 
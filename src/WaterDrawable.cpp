@@ -27,11 +27,14 @@ source distribution.
 
 #include <WaterDrawable.hpp>
 #include <Util.hpp>
+#include <JobSystem.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 
 namespace
 {
@@ -47,82 +50,53 @@ namespace
 
 }
 
-WaterDrawable::WaterDrawable(sf::Texture& normalMap, sf::Shader& shader, const sf::Vector2f& size)
+WaterDrawable::WaterDrawable(const Resource::Handle<sf::Texture>& normalMap, sf::Shader& shader, const sf::Vector2f& size)
     : m_size        (size),
     m_lightColour   (96u, 172u, 222u, 190u),//(64u, 72u, 45u, 130u),
     m_darkColour    (40u, 14u, 34u, 205u),
     m_vertices      (sf::TrianglesStrip),
     m_normalTexture (normalMap),
-    m_texHeight     (static_cast<float>(m_normalTexture.getSize().y)),
+    m_texHeight     (static_cast<float>(m_normalTexture->getSize().y)),
     m_shader        (&shader),
     m_waveIndex     (0u),
-    m_waveTime      (0.f)
+    m_waveTime      (0.f),
+    m_randomEngine  (Util::Random::value(0, 0xffff))
 {
     resize();
 
-    m_normalTexture.setRepeated(true);
+    m_normalTexture->setRepeated(true);
 }
 
 //public
 void WaterDrawable::update(float dt)
 {
-    for (auto& c : m_columns)
-        c.update(dt);
-
-    auto columnCount = m_columns.size();
-    auto endPoint = columnCount - 1u;
+    step(dt);
+    updateVertices();
+}
 
-    std::vector<float> leftDeltas(columnCount);
-    std::vector<float> rightDeltas(columnCount);
+void WaterDrawable::update(std::list<WaterDrawable>& drawables, float dt, JobSystem& jobSystem)
+{
+    //each body only touches its own columns
+    std::vector<WaterDrawable*> bodies;
+    bodies.reserve(drawables.size());
+    for (auto& d : drawables)
+        bodies.push_back(&d);
 
-    for (auto i = 0u; i < wavePasses; ++i)
+    jobSystem.parallelFor(bodies.size(), 1u, [&bodies, dt](std::size_t i)
     {
-        //calc the pull amount based on distance between surrounding points
-        for (auto j = 0u; j < columnCount; ++j)
-        {
-            if (j > 0u) //skip testing first and last points
-            {
-                leftDeltas.push_back(((m_columns[j].height - m_columns[j - 1].height) * spread) * dt);
-                m_columns[j - 1].speed += leftDeltas.back();
-            }
-            if (j < endPoint)
-            {
-                rightDeltas.push_back(((m_columns[j].height - m_columns[j + 1].height) * spread) * dt);
-                m_columns[j + 1].speed += rightDeltas.back();
-            }
-        }
-
-        //and apply 'pull' (we can't apply it right away else it affects the distance calc)
-        for (auto j = 0u; j < columnCount; ++j)
-        {
-            if (j > 0u)
-            {
-                m_columns[j - 1].height += leftDeltas[j];
-            }
-            if (j < endPoint)
-            {
-                m_columns[j + 1].height += rightDeltas[j];
-            }
-        }
-    }
-
-    //keep the surface moving
-    m_waveIndex = (m_waveIndex + 1) % waveTable.size();
-    m_columns[0].height = waveTable[m_waveIndex] * Util::Random::value(1.2f, 2.4f);
-    m_columns.back().height = -m_columns[0].height;
-
-    //update time to send to shader
-    m_waveTime += (dt * 0.1f);
+        bodies[i]->step(dt);
+        bodies[i]->updateVertices();
+    });
 }
 
 void WaterDrawable::splash(float position, float speed)
 {
     sf::Uint32 index = static_cast<sf::Uint32>(std::floor(position / pixelsPerColumn));
-    assert(index < m_columns.size());
+    assert(index < m_speeds.size());
 
-    m_columns[index].speed = speed;
-    if (index > 0) m_columns[index - 1].speed = speed;
-    if (index < m_columns.size() - 1) m_columns[index + 1].speed = speed;
+    m_speeds[index] = speed;
+    if (index > 0) m_speeds[index - 1] = speed;
+    if (index < m_speeds.size() - 1) m_speeds[index + 1] = speed;
 }
 
 void WaterDrawable::setSize(const sf::Vector2f& size)
@@ -135,47 +109,120 @@ void WaterDrawable::setColours(const sf::Color& lightColour, const sf::Color& da
 {
     m_lightColour = lightColour;
     m_darkColour = darkColour;
+
+    for (auto i = 0u; i < m_vertices.getVertexCount(); i += 2)
+    {
+        m_vertices[i].color = m_darkColour;
+        m_vertices[i + 1].color = m_lightColour;
+    }
+}
+
+void WaterDrawable::getSnapshot(Snapshot& snapshot) const
+{
+    snapshot.vertices = m_vertices;
+    snapshot.normalMap = m_normalTexture.get();
+    snapshot.shader = m_shader;
+    snapshot.waveTime = m_waveTime;
 }
 
 //private
 void WaterDrawable::resize()
 {
-    m_columns.clear();
     auto count = static_cast<sf::Uint32>(std::ceil(m_size.x / pixelsPerColumn)) + 1u;
+    m_heights.assign(count, 0.f);
+    m_speeds.assign(count, 0.f);
+    m_deltas.assign(count, 0.f);
+
+    //x positions and the bottom edge never move so are only set here
+    m_vertices.resize(count * 2u);
     for (auto i = 0u; i < count; ++i)
-        m_columns.emplace_back();
+    {
+        auto offset = std::min(static_cast<float>(i * pixelsPerColumn), m_size.x);
+
+        m_vertices[i * 2] = sf::Vertex({ offset, m_size.y }, m_darkColour, { offset, m_texHeight });
+        m_vertices[i * 2 + 1] = sf::Vertex({ offset, 0.f }, m_lightColour, { offset, 0.f });
+    }
 }
 
-void WaterDrawable::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+void WaterDrawable::step(float dt)
 {
-    //rebuild vert array - TODO flag rebuild only when necessary
-    m_vertices.clear();
-    for (auto i = 0u; i < m_columns.size(); ++i)
+    const std::size_t columnCount = m_heights.size();
+    float* heights = m_heights.data();
+    float* speeds = m_speeds.data();
+    float* deltas = m_deltas.data();
+
+    //springs pull each column back to rest (at 0)
+    for (auto i = 0u; i < columnCount; ++i)
     {
-        auto offset = std::min(static_cast<float>(i * pixelsPerColumn), m_size.x);
+        speeds[i] -= (heights[i] * tension) + (speeds[i] * dampening);
+        heights[i] += speeds[i] * dt;
+    }
+
+    if (columnCount > 1)
+    {
+        const float amount = spread * dt;
+        const std::size_t endPoint = columnCount - 1u;
+        for (auto i = 0u; i < wavePasses; ++i)
+        {
+            //calc the pull from the columns either side. this is written to scratch
+            //space first as applying it right away would affect the neighbours' calc
+            deltas[0] = (heights[1] - heights[0]) * amount;
+            for (auto j = 1u; j < endPoint; ++j)
+            {
+                deltas[j] = (heights[j - 1] + heights[j + 1] - (heights[j] * 2.f)) * amount;
+            }
+            deltas[endPoint] = (heights[endPoint - 1] - heights[endPoint]) * amount;
+
+            //and apply 'pull'
+            for (auto j = 0u; j < columnCount; ++j)
+            {
+                speeds[j] += deltas[j];
+                heights[j] += deltas[j];
+            }
+        }
+    }
+
+    //keep the surface moving
+    m_waveIndex = (m_waveIndex + 1) % waveTable.size();
+    m_heights[0] = waveTable[m_waveIndex] * std::uniform_real_distribution<float>(1.2f, 2.4f)(m_randomEngine);
+    m_heights.back() = -m_heights[0];
+
+    //update time to send to shader
+    m_waveTime += (dt * 0.1f);
+}
 
-        m_vertices.append(sf::Vertex({ offset, m_size.y }, m_darkColour, { offset, m_texHeight }));
-        m_vertices.append(sf::Vertex({ offset, m_columns[i].height }, m_lightColour, { offset, 0.f }));
+void WaterDrawable::updateVertices()
+{
+    const float threshold = 0.05f;
+    for (auto i = 0u; i < m_heights.size(); ++i)
+    {
+        auto& position = m_vertices[i * 2 + 1].position;
+        if (std::fabs(position.y - m_heights[i]) > threshold)
+        {
+            position.y = m_heights[i];
+        }
     }
-    
+}
+
+void WaterDrawable::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
     m_shader->setParameter("u_normalMap", sf::Shader::CurrentTexture); //need to do this so tex coords are correct
     m_shader->setParameter("u_inverseWorldViewMatrix", states.transform.getInverse());
     m_shader->setParameter("u_textureOffset", m_waveTime);
 
     states.shader = m_shader;
-    states.texture = &m_normalTexture;
+    states.texture = m_normalTexture.get();
     //states.blendMode = sf::BlendMultiply;
     rt.draw(m_vertices, states);
 }
 
-WaterDrawable::Column::Column()
-    : targetHeight  (0.f),
-    height          (0.f),
-    speed           (0.f){}
-
-void WaterDrawable::Column::update(float dt)
+void WaterDrawable::Snapshot::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
-    float amount = targetHeight - height;
-    speed += (amount * tension) - (speed * dampening);
-    height += speed * dt;
+    shader->setParameter("u_normalMap", sf::Shader::CurrentTexture);
+    shader->setParameter("u_inverseWorldViewMatrix", states.transform.getInverse());
+    shader->setParameter("u_textureOffset", waveTime);
+
+    states.shader = shader;
+    states.texture = normalMap;
+    rt.draw(vertices, states);
 }
\ No newline at end of file
@@ -28,17 +28,103 @@ source distribution.
 //main entry point for game
 
 #include <Game.hpp>
+#include <Profiler.hpp>
+#include <AllocationHook.hpp>
 
 #ifdef __linux
 #include <X11/Xlib.h>
 #endif //__linux
 
-int main()
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace
+{
+    const sf::Uint32 defaultHeadlessTicks = 10000u;
+    const std::size_t allocationWarmupTicks = 300u;
+}
+
+//crush --headless [--map <name>] [--ticks <count>] runs the simulation
+//without a window or audio, then prints timing statistics. builds with
+//CRUSH_TRACK_ALLOCATIONS also take --alloc-assert <scope path...>, which
+//aborts the run if those profiler scopes allocate once warmed up
+int main(int argc, char** argv)
 {
 #ifdef __linux
     XInitThreads();
 #endif //__linux
 
+#ifdef CRUSH_TRACK_ALLOCATIONS
+    AllocationHook::setCallback(Profiler::recordAllocation);
+#endif //CRUSH_TRACK_ALLOCATIONS
+
+    bool headless = false;
+    std::string map;
+    sf::Uint32 ticks = defaultHeadlessTicks;
+    std::vector<std::string> allocationScopes;
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg == "--map" && i + 1 < argc)
+        {
+            map = argv[++i];
+        }
+        else if (arg == "--ticks" && i + 1 < argc)
+        {
+            try
+            {
+                ticks = static_cast<sf::Uint32>(std::stoul(argv[++i]));
+            }
+            catch (...)
+            {
+                std::cerr << argv[i] << ": invalid tick count" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--alloc-assert")
+        {
+            //every following argument up to the next option is a scope path
+            while (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0)
+                allocationScopes.push_back(argv[++i]);
+
+            if (allocationScopes.empty())
+            {
+                std::cerr << "--alloc-assert: missing scope path" << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            std::cerr << "usage: crush [--headless [--map <name>] [--ticks <count>] [--alloc-assert <scope path...>]]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!headless && !allocationScopes.empty())
+    {
+        std::cerr << "--alloc-assert: only supported with --headless" << std::endl;
+        return 1;
+    }
+
+    if (headless)
+    {
+        Game game(true);
+        if (!allocationScopes.empty())
+        {
+#ifdef CRUSH_TRACK_ALLOCATIONS
+            Profiler::setAllocationAssert(allocationScopes, allocationWarmupTicks);
+#else
+            std::cerr << "--alloc-assert: allocation tracking is not enabled in this build" << std::endl;
+            return 1;
+#endif //CRUSH_TRACK_ALLOCATIONS
+        }
+        return game.runHeadless(map, ticks);
+    }
 
     Game game;
     game.run();